@@ -0,0 +1,368 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <chrono>
+#include <new>
+
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#include "MazeViewer.h"
+
+#if defined(_WIN32)
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#endif
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+const unsigned int SEED = 0x9E3779B9;	// base seed, repetition r uses SEED + r so every run sees the same mazes
+const size_t GENERATOR_NODES = size_t(1) << 22;	// the other generators are only timed up to this many nodes, WILSON and KRUSKAL get slow
+const int WALL_EDITS = 256;	// cells toggled by SetCell per repetition, each followed by FindShortestPath
+
+struct GeneratorStage
+{
+	MazeCore::GeneratorMode mode;
+	const char* stage;
+};
+
+const GeneratorStage GENERATORS[] =	// timed next to RandomizeMaze, which uses the default RECURSIVE_BACKTRACKER
+{
+	{ MazeCore::TILED_BACKTRACKER, "TiledBacktracker" },
+	{ MazeCore::ITERATIVE_BACKTRACKER, "IterativeBacktracker" },
+	{ MazeCore::ELLER, "Eller" },
+	{ MazeCore::BINARY_TREE, "BinaryTree" },
+	{ MazeCore::SIDEWINDER, "Sidewinder" },
+	{ MazeCore::KRUSKAL, "Kruskal" },
+	{ MazeCore::WILSON, "Wilson" }
+};
+
+void ResetPeakRSS()	// start a new high-water mark at the current resident set, so ResidentBytes(true) only covers what ran since
+{
+#if defined(__linux__)
+	std::ofstream("/proc/self/clear_refs") << "5";	// resets VmHWM to VmRSS
+#endif
+}
+
+size_t ResidentBytes(bool peak)	// resident set size in bytes, or its high-water mark since ResetPeakRSS, Windows and macOS cannot reset their peak so both give the current size there
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.WorkingSetSize;
+#elif defined(__APPLE__)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count);
+	return info.resident_size;
+#else
+	const char* field = peak ? "VmHWM:" : "VmRSS:";
+	std::ifstream status("/proc/self/status");
+	for (std::string line; std::getline(status, line);)
+		if (!line.compare(0, 6, field))
+			return size_t(strtoull(line.c_str() + 6, nullptr, 10)) * 1024;	// kilobytes
+	return 0;
+#endif
+}
+
+size_t stageBaseline = 0;	// resident bytes when the running stage started, buffers earlier stages left behind are not charged to it
+
+high_resolution_clock::time_point StartStage()	// the clock for one repetition of a stage, with the memory high-water mark reset so each stage reports only what it added
+{
+#if defined(__GLIBC__)
+	malloc_trim(0);	// hand freed heap pages back, or a stage reusing them would look free
+#endif
+	ResetPeakRSS();
+	stageBaseline = ResidentBytes(false);
+	return high_resolution_clock::now();
+}
+
+size_t PhysicalMemory()	// installed memory in bytes, used to skip sizes that cannot fit
+{
+#if defined(_WIN32)
+	MEMORYSTATUSEX status;
+	status.dwLength = sizeof(status);
+	GlobalMemoryStatusEx(&status);
+	return status.ullTotalPhys;
+#else
+	return size_t(sysconf(_SC_PHYS_PAGES)) * size_t(sysconf(_SC_PAGE_SIZE));
+#endif
+}
+
+struct Timing
+{
+	const char* stage;
+	double bestNanoseconds = 1e300;	// fastest repetition, the least disturbed by the rest of the system
+	size_t cells = 0;				// cells processed by that repetition
+	size_t peakBytes = 0;			// most resident memory any repetition added while it ran, usually the first, which touches the stage's buffers
+};
+
+void Record(Timing& timing, double elapsed, size_t cells)	// one repetition of a stage started by StartStage
+{
+	if (elapsed < timing.bestNanoseconds) { timing.bestNanoseconds = elapsed; timing.cells = cells; }
+	size_t peak = ResidentBytes(true);
+	timing.peakBytes = std::max(timing.peakBytes, peak > stageBaseline ? peak - stageBaseline : 0);
+}
+
+void Report(std::ostream& out, const Timing& timing, const char* layout, int width, int height, int repetitions)
+{
+	double nsPerCell = timing.bestNanoseconds / (timing.cells ? timing.cells : 1);
+	out << timing.stage << ',' << layout << ',' << width << ',' << height << ',' << timing.cells << ',' << SEED << ',' << repetitions << ','
+		<< nsPerCell << ',' << 1e9 / nsPerCell << ',' << timing.peakBytes << '\n';
+}
+
+void BenchmarkLayout(std::ostream& file, int width, int height, int mutationRate, bool border, bool packed, int repetitions)	// one csv row per stage for one maze size and storage layout
+{
+	size_t filledCells = size_t(width) * height * 4;
+	const char* layout = packed ? (border ? "packed-border" : "packed") : (border ? "border" : "dense");
+	Timing firstScene = { "FirstScene" };		// building the maze and its first NewScene, its memory is the footprint of the layout
+	Timing generate = { "RandomizeMaze" };
+	std::vector<Timing> generators;	// one per GENERATORS entry, small mazes only
+	for (const GeneratorStage& generator : GENERATORS)
+		generators.push_back({ generator.stage });
+	Timing flood = { "FindShortestPath" };
+	Timing serial = { "SerialBFS" };			// scalar BFS on one thread, FindShortestPath above it goes multithreaded from PARALLEL_SOLVE_THRESHOLD
+	Timing bitParallel = { "BitParallelBFS" };	// packed layouts only
+	Timing trace = { "Backtrack" };
+	Timing bidirectional = { "BidirectionalBFS" };	// POINT_TO_POINT query between the same player and goal
+	Timing astar = { "AStar" };
+	Timing jumpPoint = { "JumpPointSearch" };
+	Timing buildLandmarks = { "BuildLandmarks" };	// default LANDMARK_BUDGET, skipped once it cannot fit one landmark
+	Timing landmarks = { "LandmarkAStar" };
+	Timing buildTree = { "BuildTree" };			// the same maze without mutations, so it is a tree
+	Timing treeQuery = { "TreeQuery" };
+	Timing incremental = { "IncrementalGoal" };	// INCREMENTAL_SOLVE, a new goal after the player reached the old one
+	Timing wallEdit = { "WallEdit" };			// one SetCell and the path after it, averaged over WALL_EDITS
+	Timing draw = { "DrawMaze" };				// the fade kernel MazeFade::Detect picks
+	Timing drawScalar = { "DrawMazeScalar" };	// the same with MazeFade::SCALAR, for the speedup
+	Timing steadyFrame = { "SteadyFrame" };		// Render once the fade has settled, only the trails are redrawn
+
+	try
+	{
+		auto start = StartStage();
+		Maze maze(width, height, mutationRate, border, packed);
+		olc::Sprite target(maze.mazeFilledWidth, maze.mazeFilledHeight);
+		maze.SetDrawTarget(&target);	// draw into an offscreen sprite, no window is created
+		maze.Reseed(SEED);
+		maze.NewScene();				// touches the grids, the distance field and the frontier
+		Record(firstScene, double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count()), filledCells);
+
+		for (int r = 0; r < repetitions; r++)
+		{
+			maze.Reseed(SEED + r);
+
+			start = StartStage();
+			maze.RandomizeMaze();
+			double elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			Record(generate, elapsed, filledCells);
+
+			maze.RandomizePlayer();
+			maze.RandomizeGoal();
+
+			start = StartStage();
+			maze.FloodDistances();
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			Record(flood, elapsed, filledCells);
+
+			if (std::thread::hardware_concurrency() > 1 && maze.storedCells >= maze.PARALLEL_SOLVE_THRESHOLD)
+			{
+				maze.SOLVER_THREADS = 1;
+				start = StartStage();
+				maze.FloodDistances();
+				elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+				Record(serial, elapsed, filledCells);
+				maze.SOLVER_THREADS = 0;
+			}
+
+			if (packed)
+			{
+				maze.SOLVER = MazeCore::BIT_PARALLEL_BFS;
+				start = StartStage();
+				maze.FloodDistances();
+				elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+				Record(bitParallel, elapsed, filledCells);
+				maze.SOLVER = MazeCore::SCALAR_BFS;
+			}
+
+			start = StartStage();
+			maze.TracePath();
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			Record(trace, elapsed, maze.largestDistance);	// the backtrack only walks the path
+
+			const MazeFade::Kernel detected = maze.FADE_KERNEL;
+			for (auto [kernel, timing] : { std::pair{ detected, &draw }, { MazeFade::SCALAR, &drawScalar } })
+			{
+				for (size_t i = filledCells; i--;)
+					maze.drawingColor[i] = 255;
+				maze.FADE_KERNEL = kernel;
+				maze.InvalidateTiles(false);
+				start = StartStage();
+				maze.DrawMaze();
+				elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+				Record(*timing, elapsed, filledCells);
+			}
+			maze.FADE_KERNEL = detected;
+
+			maze.InvalidateTiles(true);
+			for (int settle = 0; settle < 16 && std::count(maze.fadingTiles, maze.fadingTiles + maze.tilesWide * maze.tilesHigh, 1); settle++)
+				maze.DrawMaze(1 << 12);	// each call covers most of the remaining way, the snap ends it
+			maze.Render();
+			maze.pendingFades = 1;		// one simulation step since the last frame
+			start = StartStage();
+			maze.Render();
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			Record(steadyFrame, elapsed, filledCells);
+
+			start = StartStage();
+			maze.BuildLandmarks();
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			if (maze.landmarkCount)
+				Record(buildLandmarks, elapsed, filledCells);
+
+			for (auto [query, timing] : { std::pair{ MazeCore::POINT_TO_POINT, &bidirectional }, { MazeCore::ASTAR, &astar }, { MazeCore::JUMP_POINT, &jumpPoint }, { MazeCore::LANDMARKS, &landmarks } })
+			{
+				if (query == MazeCore::LANDMARKS && !maze.landmarkCount)
+					continue;
+				maze.QUERY = query;
+				start = StartStage();
+				maze.FindShortestPath();
+				elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+				Record(*timing, elapsed, filledCells);
+			}
+			maze.QUERY = MazeCore::DISTANCE_FIELD;
+
+			maze.INCREMENTAL_SOLVE = true;
+			maze.FindShortestPath();					// flood from the goal until it reaches the player
+			maze.playerPosition = maze.goalPosition;	// what MovePlayer does on arrival
+			maze.RandomizeGoal();
+			start = StartStage();
+			maze.FindShortestPath();
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			Record(incremental, elapsed, filledCells);
+			maze.INCREMENTAL_SOLVE = false;
+
+			maze.FindShortestPath();	// a complete field for SetCell to repair
+			unsigned int editState = MazeCore::MixSeed(SEED + r, 0);
+			start = StartStage();
+			for (int e = WALL_EDITS; e--;)
+			{
+				int x = int(MazeCore::XorShift32(editState) % maze.mazeFilledWidth);
+				int y = int(MazeCore::XorShift32(editState) % maze.mazeFilledHeight);
+				maze.SetCell(x, y, !maze.IsPath(maze.Index(x, y)));
+				maze.FindShortestPath();
+			}
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count()) / WALL_EDITS;
+			Record(wallEdit, elapsed, filledCells);
+
+			for (size_t g = 0; g < generators.size() && size_t(width) * height <= GENERATOR_NODES; g++)	// last, the stages above always see the default maze
+			{
+				maze.Reseed(SEED + r);
+				maze.GENERATOR = GENERATORS[g].mode;
+				start = StartStage();
+				maze.RandomizeMaze();
+				elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+				Record(generators[g], elapsed, filledCells);
+			}
+			maze.GENERATOR = MazeCore::RECURSIVE_BACKTRACKER;
+
+			maze.Reseed(SEED + r);
+			maze.MUTATION_RATE = 0;
+			maze.RandomizeMaze();
+			maze.RandomizePlayer();
+			maze.RandomizeGoal();
+			start = StartStage();
+			maze.BuildTree();
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			Record(buildTree, elapsed, filledCells);
+			maze.QUERY = MazeCore::TREE;
+			start = StartStage();
+			maze.FindShortestPath();
+			elapsed = double(duration_cast<nanoseconds>(high_resolution_clock::now() - start).count());
+			Record(treeQuery, elapsed, filledCells);
+			maze.QUERY = MazeCore::DISTANCE_FIELD;
+			maze.MUTATION_RATE = mutationRate;
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		std::cout << "skipped " << width << 'x' << height << ' ' << layout << ", out of memory\n";
+		return;
+	}
+
+	std::vector<const Timing*> timings = { &firstScene, &generate };
+	for (const Timing& timing : generators)
+		timings.push_back(&timing);
+	for (const Timing* timing : { &flood, &serial, &bitParallel, &trace, &draw, &drawScalar, &steadyFrame, &bidirectional, &astar, &jumpPoint, &buildLandmarks, &landmarks, &buildTree, &treeQuery, &incremental, &wallEdit })
+		timings.push_back(timing);
+
+	for (const Timing* timing : timings)
+	{
+		if (!timing->cells)
+			continue;
+		Report(file, *timing, layout, width, height, repetitions);
+		Report(std::cout, *timing, layout, width, height, repetitions);
+	}
+}
+
+// Times the hot paths of the maze for a ladder of sizes and writes one csv row per stage, usage:
+// maze-benchmark [output file] [largest maze width]
+int main(int argc, char** argv)
+{
+	const char* OUTPUT = argc > 1 ? argv[1] : "maze-benchmark.csv";	// machine readable results
+	const int LARGEST_WIDTH = argc > 2 ? atoi(argv[2]) : 32768;		// stop the ladder after this width
+
+	const int SIZES[][2] = { {200, 100}, {512, 512}, {1024, 1024}, {2048, 2048}, {4096, 4096}, {8192, 8192}, {16384, 16384}, {32768, 32768} };
+	const int MUTATION_RATE = 80;	// same as the viewer default
+
+	std::ofstream file(OUTPUT);
+	if (!file)
+	{
+		std::cerr << "cannot open " << OUTPUT << '\n';
+		return 1;
+	}
+	const char* header = "stage,layout,width,height,cells,seed,repetitions,ns_per_cell,cells_per_second,stage_peak_bytes\n";
+	file << header;
+	std::cout << header;
+
+	for (auto& size : SIZES)
+	{
+		int width = size[0];
+		int height = size[1];
+		if (width > LARGEST_WIDTH)
+			break;
+
+		size_t filledCells = size_t(width) * height * 4;
+		size_t storedCells = size_t(width * 2 + 64) * (height * 2 + 2);	// largest layout, packed rows with the sentinel border
+		size_t bytesPerCell = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(float) + sizeof(olc::Pixel);	// maze, distances, frontier, drawingColor, draw target
+		if (!MazeCore::Fits(width, height, true, true))
+		{
+			std::cout << "skipped " << width << 'x' << height << ", " << storedCells << " stored cells do not fit 32 bit cell indices\n";
+			continue;
+		}
+		if (storedCells * bytesPerCell > PhysicalMemory())
+		{
+			std::cout << "skipped " << width << 'x' << height << ", needs " << storedCells * bytesPerCell / (1 << 20) << " MiB\n";
+			continue;
+		}
+
+		int repetitions = int(std::max<size_t>(1, (size_t(1) << 22) / filledCells));	// enough repetitions to smooth out small sizes
+		for (bool packed : { false, true })
+			for (bool border : { false, true })
+				BenchmarkLayout(file, width, height, MUTATION_RATE, border, packed, repetitions);
+	}
+
+	return 0;
+}
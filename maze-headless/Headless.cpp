@@ -0,0 +1,316 @@
+#include <iostream>
+#include <cstdlib>
+#include <climits>
+#include <cstring>
+#include <chrono>
+
+#include "MazeCore.h"
+#include "MazeStream.h"
+#include "MazeFile.h"
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+// Writes an ELLER maze of any size to a PBM image one row at a time without holding it in memory, usage:
+// maze-headless stream <width> <height> <mutation rate> <seed> <output.pbm>
+int Stream(int argc, char** argv)
+{
+	const int MAZE_WIDTH = argc > 2 ? atoi(argv[2]) : 0;
+	const int MAZE_HEIGHT = argc > 3 ? atoi(argv[3]) : 0;
+	const int MUTATION_RATE = argc > 4 ? atoi(argv[4]) : 0;
+	const unsigned int SEED = argc > 5 ? unsigned(strtoul(argv[5], nullptr, 0)) : 0;
+	const char* OUTPUT = argc > 6 ? argv[6] : nullptr;
+
+	if (MAZE_WIDTH <= 0 || MAZE_WIDTH > INT_MAX / 2 || MAZE_HEIGHT <= 0 || MAZE_HEIGHT > INT_MAX / 2 || MUTATION_RATE < 0 || !OUTPUT)
+	{
+		std::cerr << "usage: maze-headless stream <width> <height> <mutation rate> <seed> <output.pbm>\n";
+		return 1;
+	}
+
+	MazeStream stream(MAZE_WIDTH, MAZE_HEIGHT, MUTATION_RATE, SEED);
+	auto start = high_resolution_clock::now();
+	if (!stream.WriteBitmap(OUTPUT))
+	{
+		std::cerr << "cannot write " << OUTPUT << '\n';
+		return 1;
+	}
+	double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() * 1e-9;
+
+	std::cout << "size:             " << MAZE_WIDTH << 'x' << MAZE_HEIGHT << '\n';
+	std::cout << "seconds:          " << seconds << '\n';
+	std::cout << "nodes per second: " << double(MAZE_WIDTH) * MAZE_HEIGHT / seconds << '\n';
+
+	return 0;
+}
+
+// Generates and solves one scene and writes it to a maze file, usage:
+// maze-headless save <width> <height> <mutation rate> <seed> <output.maze> [sentinel border 0|1] [distances 0|1]
+int Save(int argc, char** argv)
+{
+	const int MAZE_WIDTH = argc > 2 ? atoi(argv[2]) : 0;
+	const int MAZE_HEIGHT = argc > 3 ? atoi(argv[3]) : 0;
+	const int MUTATION_RATE = argc > 4 ? atoi(argv[4]) : 0;
+	const unsigned int SEED = argc > 5 ? unsigned(strtoul(argv[5], nullptr, 0)) : 0;
+	const char* OUTPUT = argc > 6 ? argv[6] : nullptr;
+	const bool SENTINEL_BORDER = argc > 7 && atoi(argv[7]);
+	const bool DISTANCES = argc <= 8 || atoi(argv[8]);	// store the distance field so loading can skip the solver too
+
+	if (MAZE_WIDTH <= 0 || MAZE_HEIGHT <= 0 || MUTATION_RATE < 0 || !OUTPUT)
+	{
+		std::cerr << "usage: maze-headless save <width> <height> <mutation rate> <seed> <output.maze> [sentinel border 0|1] [distances 0|1]\n";
+		return 1;
+	}
+	if (!MazeCore::Fits(MAZE_WIDTH, MAZE_HEIGHT, SENTINEL_BORDER, true))
+	{
+		std::cerr << MAZE_WIDTH << 'x' << MAZE_HEIGHT << " has more than 2^32 stored cells, use stream for mazes this large\n";
+		return 1;
+	}
+
+	MazeCore maze(MAZE_WIDTH, MAZE_HEIGHT, MUTATION_RATE, SENTINEL_BORDER, true, SEED);
+	maze.NewScene();
+	if (!MazeFile::Save(maze, OUTPUT, DISTANCES))
+	{
+		std::cerr << "cannot write " << OUTPUT << '\n';
+		return 1;
+	}
+
+	std::cout << "size:             " << MAZE_WIDTH << 'x' << MAZE_HEIGHT << '\n';
+	std::cout << "seed:             " << maze.seed << '\n';
+	std::cout << "path:             " << maze.largestDistance << '\n';
+
+	return 0;
+}
+
+// Maps a maze file and walks its path, solving only if no distance field was stored, usage:
+// maze-headless load <input.maze>
+int Load(int argc, char** argv)
+{
+	if (argc <= 2)
+	{
+		std::cerr << "usage: maze-headless load <input.maze>\n";
+		return 1;
+	}
+
+	auto start = high_resolution_clock::now();
+	MazeFile file;	// declared before the maze so it is unmapped after it
+	if (!file.Open(argv[2]))
+	{
+		std::cerr << "cannot open " << argv[2] << " as a maze file\n";
+		return 1;
+	}
+	if (!MazeCore::Fits(file.header.width, file.header.height, file.header.flags & MazeFile::BORDER_FLAG, true))
+	{
+		std::cerr << argv[2] << " has more than 2^32 stored cells\n";
+		return 1;
+	}
+	MazeCore maze(file.header.width, file.header.height, file.header.mutationRate, file.header.flags & MazeFile::BORDER_FLAG, true, file.header.seed);
+	if (!file.Attach(maze))
+	{
+		std::cerr << argv[2] << " does not match its own header\n";
+		return 1;
+	}
+	double openSeconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() * 1e-9;
+
+	start = high_resolution_clock::now();
+	maze.FindShortestPath();	// only traces the path when Attach handed over the stored field
+	double solveSeconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() * 1e-9;
+
+	std::cout << "size:             " << maze.MAZE_WIDTH << 'x' << maze.MAZE_HEIGHT << '\n';
+	std::cout << "seed:             " << maze.seed << '\n';
+	std::cout << "open seconds:     " << openSeconds << '\n';
+	std::cout << (file.HasDistances() ? "trace seconds:    " : "solve seconds:    ") << solveSeconds << '\n';
+	std::cout << "path:             " << maze.largestDistance << '\n';
+
+	return 0;
+}
+
+bool MatchesReference(const MazeCore& maze, const MazeCore& reference)	// same path length as the reference and a walk of open cells from the goal to next to the player
+{
+	const size_t length = reference.largestDistance;
+	if (maze.largestDistance != length || maze.shortestPath.size() != length)
+		return false;
+	vi2d previous = maze.playerPosition;
+	for (size_t i = length; i--;)
+	{
+		vi2d cell = maze.shortestPath[i];
+		if (abs(cell.x - previous.x) + abs(cell.y - previous.y) != 1 || cell.x < 0 || cell.x >= maze.mazeFilledWidth || cell.y < 0 || cell.y >= maze.mazeFilledHeight || !maze.IsPath(maze.Index(cell.x, cell.y)))
+			return false;
+		previous = cell;
+	}
+	return !length || previous == maze.goalPosition;
+}
+
+// Checks every solver engine, INCREMENTAL_SOLVE, fields kept across SetCell and every query mode against a fresh serial flood of the same mazes, usage:
+// maze-headless check [width] [height] [mutation rate] [scenes] [seed]
+int Check(int argc, char** argv)
+{
+	const int MAZE_WIDTH = argc > 2 ? atoi(argv[2]) : 40;
+	const int MAZE_HEIGHT = argc > 3 ? atoi(argv[3]) : 30;
+	const int MUTATION_RATE = argc > 4 ? atoi(argv[4]) : 10;	// every other scene is made without mutations so TREE gets a tree
+	const int SCENES = argc > 5 ? atoi(argv[5]) : 20;
+	const unsigned int SEED = argc > 6 ? unsigned(strtoul(argv[6], nullptr, 0)) : 1;
+	const int GOALS = 8;	// goals per scene, every other one after a wall edit
+
+	if (MAZE_WIDTH <= 0 || MAZE_HEIGHT <= 0 || MUTATION_RATE < 0 || SCENES <= 0 || !SEED || !MazeCore::Fits(MAZE_WIDTH, MAZE_HEIGHT, true, true))
+	{
+		std::cerr << "usage: maze-headless check [width] [height] [mutation rate] [scenes] [seed]\n";
+		return 1;
+	}
+
+	const char* ENGINES[] = { "serial", "threaded", "bit parallel" };
+	long long checks = 0;
+	long long failures = 0;
+	for (int layout = 0; layout < 4; layout++)
+		for (int engine = 0; engine < 3; engine++)
+			for (bool incremental : { false, true })
+			{
+				const bool packed = layout & 2;
+				if (engine == 2 && !packed)
+					continue;	// BIT_PARALLEL_BFS needs the packed grid
+				MazeCore maze(MAZE_WIDTH, MAZE_HEIGHT, MUTATION_RATE, layout & 1, packed, SEED);
+				MazeCore reference(MAZE_WIDTH, MAZE_HEIGHT, MUTATION_RATE, layout & 1, packed, SEED);
+				maze.SOLVER = engine == 2 ? MazeCore::BIT_PARALLEL_BFS : MazeCore::SCALAR_BFS;
+				maze.SOLVER_THREADS = engine == 1 ? 4 : 1;
+				maze.PARALLEL_SOLVE_THRESHOLD = 0;	// threaded from the first level on, whatever the size
+				maze.PARALLEL_LEVEL_SIZE = 0;
+				reference.SOLVER_THREADS = 1;
+				unsigned int editState = MazeCore::MixSeed(SEED, 0);
+
+				auto compare = [&](const char* what)
+				{
+					checks++;
+					if (MatchesReference(maze, reference))
+						return;
+					if (!failures++)
+						std::cerr << "first failure: " << what << ", layout " << layout << ", " << ENGINES[engine] << (incremental ? " incremental" : "") << " solver, seed " << maze.seed << '\n';
+				};
+
+				for (int scene = 0; scene < SCENES; scene++)
+				{
+					maze.MUTATION_RATE = reference.MUTATION_RATE = scene % 2 ? MUTATION_RATE : 0;
+					maze.NewScene();
+					reference.NewScene();
+					compare("new scene");
+					for (int goal = 1; goal < GOALS; goal++)
+					{
+						if (goal % 2)
+						{
+							int x = int(MazeCore::XorShift32(editState) % maze.mazeFilledWidth);	// never the player or the goal, both stay on paths
+							int y = int(MazeCore::XorShift32(editState) % maze.mazeFilledHeight);
+							if (vi2d{ x, y } != reference.playerPosition && vi2d{ x, y } != reference.goalPosition)
+							{
+								bool path = !reference.IsPath(reference.Index(x, y));
+								maze.SetCell(x, y, path);
+								reference.SetCell(x, y, path);
+							}
+						}
+						if (reference.largestDistance)
+							maze.playerPosition = reference.playerPosition = reference.goalPosition;	// arrive at the goal like MovePlayer
+						maze.RandomizeGoal();
+						reference.RandomizeGoal();
+
+						reference.FloodDistances();	// from scratch, nothing kept
+						reference.FinishQuery();
+						maze.INCREMENTAL_SOLVE = incremental && goal % 3;	// also carries on from fields the engine flooded
+						maze.FindShortestPath();
+						compare("distance field");
+
+						for (MazeCore::QueryMode query : { MazeCore::POINT_TO_POINT, MazeCore::ASTAR, MazeCore::JUMP_POINT, MazeCore::LANDMARKS, MazeCore::TREE })
+						{
+							maze.QUERY = query;
+							maze.FindShortestPath();
+							compare("query mode");
+						}
+						maze.QUERY = MazeCore::DISTANCE_FIELD;
+						maze.FindShortestPath();	// after the queries left part of a field
+						compare("distance field after queries");
+					}
+				}
+			}
+
+	std::cout << "checks:           " << checks << '\n';
+	std::cout << "failures:         " << failures << '\n';
+	return failures ? 1 : 0;
+}
+
+// Runs the maze generator and solver without a window, usage:
+// maze-headless [width] [height] [mutation rate, 0 none] [scenes] [sentinel border 0|1] [packed walls 0|1] [solver 0 scalar|1 bit parallel] [solver threads, 0 all] [generator 0 backtracker|1 tiled|2 iterative|3 eller|4 binary tree|5 sidewinder|6 kruskal|7 wilson] [seed, 0 from the clock] [query 0 distance field|1 point to point|2 a*|3 jump point|4 landmarks|5 tree] [goals per scene] [incremental solve 0|1] [landmark budget MiB]
+int main(int argc, char** argv)
+{
+	if (argc > 1 && !strcmp(argv[1], "stream"))
+		return Stream(argc, argv);
+	if (argc > 1 && !strcmp(argv[1], "save"))
+		return Save(argc, argv);
+	if (argc > 1 && !strcmp(argv[1], "load"))
+		return Load(argc, argv);
+	if (argc > 1 && !strcmp(argv[1], "check"))
+		return Check(argc, argv);
+
+	const int MAZE_WIDTH = argc > 1 ? atoi(argv[1]) : 200;		// width of the maze
+	const int MAZE_HEIGHT = argc > 2 ? atoi(argv[2]) : 100;		// height of the maze
+	const int MUTATION_RATE = argc > 3 ? atoi(argv[3]) : 80;	// 1 in MUTATION_RATE chance to flip a cell into a path, 0 keeps the maze a tree
+	const long long SCENES = argc > 4 ? atoll(argv[4]) : 1000;	// how many mazes to generate and solve
+	const bool SENTINEL_BORDER = argc > 5 && atoi(argv[5]);		// pad the grids with a wall so the inner loops skip bounds checks
+	const bool PACKED_WALLS = argc > 6 && atoi(argv[6]);		// one bit per cell for the wall grid
+	const int SOLVER = argc > 7 ? atoi(argv[7]) : 0;			// MazeCore::SolverEngine
+	const int SOLVER_THREADS = argc > 8 ? atoi(argv[8]) : 0;	// threads for the BFS on large grids
+	const int GENERATOR = argc > 9 ? atoi(argv[9]) : 0;			// MazeCore::GeneratorMode, tiles use every hardware thread
+	const unsigned int SEED = argc > 10 ? unsigned(strtoul(argv[10], nullptr, 0)) : 0;	// same seed, same mazes, whatever solver is picked
+	const int QUERY = argc > 11 ? atoi(argv[11]) : 0;			// MazeCore::QueryMode
+	const int GOALS = argc > 12 ? atoi(argv[12]) : 1;			// goals the player walks to in each maze, like the viewer does
+	const bool INCREMENTAL_SOLVE = argc > 13 && atoi(argv[13]);	// keep the distance field between goals of the same maze
+	const long long LANDMARK_BUDGET = argc > 14 ? atoll(argv[14]) : 64;	// MiB for the LANDMARKS oracle, built once per maze
+
+	if (MAZE_WIDTH <= 0 || MAZE_HEIGHT <= 0 || MUTATION_RATE < 0 || SCENES <= 0 || SOLVER < 0 || SOLVER > MazeCore::BIT_PARALLEL_BFS || GENERATOR < 0 || GENERATOR > MazeCore::WILSON || QUERY < 0 || QUERY > MazeCore::TREE || GOALS <= 0 || LANDMARK_BUDGET < 0)
+	{
+		std::cerr << "usage: maze-headless [width] [height] [mutation rate, 0 none] [scenes] [sentinel border 0|1] [packed walls 0|1] [solver 0 scalar|1 bit parallel] [solver threads, 0 all] [generator 0 backtracker|1 tiled|2 iterative|3 eller|4 binary tree|5 sidewinder|6 kruskal|7 wilson] [seed, 0 from the clock] [query 0 distance field|1 point to point|2 a*|3 jump point|4 landmarks|5 tree] [goals per scene] [incremental solve 0|1] [landmark budget MiB]\n";
+		return 1;
+	}
+	if (!MazeCore::Fits(MAZE_WIDTH, MAZE_HEIGHT, SENTINEL_BORDER, PACKED_WALLS))
+	{
+		std::cerr << MAZE_WIDTH << 'x' << MAZE_HEIGHT << " has more than 2^32 stored cells, cell indices are 32 bit\n";
+		return 1;
+	}
+
+	MazeCore maze(MAZE_WIDTH, MAZE_HEIGHT, MUTATION_RATE, SENTINEL_BORDER, PACKED_WALLS, SEED);
+	maze.SOLVER = MazeCore::SolverEngine(SOLVER);
+	maze.SOLVER_THREADS = SOLVER_THREADS;
+	maze.GENERATOR = MazeCore::GeneratorMode(GENERATOR);
+	maze.QUERY = MazeCore::QueryMode(QUERY);
+	maze.INCREMENTAL_SOLVE = INCREMENTAL_SOLVE;
+	maze.LANDMARK_BUDGET = size_t(LANDMARK_BUDGET) << 20;
+
+	size_t totalPathLength = 0;
+	size_t totalExpanded = 0;
+	auto start = high_resolution_clock::now();
+	for (long long i = SCENES; i--;)
+	{
+		maze.NewScene();							// generate and solve a new maze
+		totalPathLength += maze.largestDistance;
+		totalExpanded += maze.expandedCells;
+		for (int g = 1; g < GOALS; g++)
+		{
+			if (maze.QUERY == MazeCore::LANDMARKS || maze.QUERY == MazeCore::TREE)
+				maze.RandomizePlayer();						// random pairs on one maze, what the oracle is built for
+			else if (maze.largestDistance)
+				maze.playerPosition = maze.goalPosition;	// arrive at the goal, MovePlayer without the steps
+			maze.RandomizeGoal();
+			maze.FindShortestPath();
+			totalPathLength += maze.largestDistance;
+			totalExpanded += maze.expandedCells;
+		}
+	}
+	double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() * 1e-9;
+
+	std::cout << "mazes:            " << SCENES << '\n';
+	std::cout << "size:             " << MAZE_WIDTH << 'x' << MAZE_HEIGHT << '\n';
+	std::cout << "seed:             " << maze.seed << '\n';	// printed so a clock seeded run can be replayed
+	std::cout << "seconds:          " << seconds << '\n';
+	std::cout << "mazes per second: " << SCENES / seconds << '\n';
+	std::cout << "average path:     " << double(totalPathLength) / (SCENES * GOALS) << '\n';
+	if (maze.QUERY == MazeCore::ASTAR || maze.QUERY == MazeCore::JUMP_POINT || maze.QUERY == MazeCore::LANDMARKS)
+		std::cout << "average expanded: " << double(totalExpanded) / (SCENES * GOALS) << '\n';
+
+	return 0;
+}
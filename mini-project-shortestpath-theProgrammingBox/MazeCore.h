@@ -0,0 +1,2103 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+struct vi2d		// same as olc::vi2d, kept here so the core does not depend on the Pixel Game Engine
+{
+	int x = 0;
+	int y = 0;
+
+	vi2d operator+(const vi2d& rhs) const { return { x + rhs.x, y + rhs.y }; }
+	bool operator==(const vi2d& rhs) const { return x == rhs.x && y == rhs.y; }
+	bool operator!=(const vi2d& rhs) const { return !(*this == rhs); }
+};
+
+class MazeCore	// maze grid, generator and solver, runs without a window so it can be driven headless or from a viewer
+{
+public:
+	int MAZE_WIDTH;				// Width of the maze
+	int MAZE_HEIGHT;			// Height of the maze
+	int MUTATION_RATE;			// chance that a wall gets flipped into a path, 0 or less for none so the maze stays a spanning tree
+	bool SENTINEL_BORDER;		// surround the grids with a one cell wall so neighbour lookups need no bounds checks
+	bool PACKED_WALLS;			// store the PATH flag of maze as one bit per cell in mazeBits instead of a byte in maze, distances stay 4 bytes so a large maze takes about 4.75 bytes per cell flooded by BIT_PARALLEL_BFS and 8.4 by SCALAR_BFS, 9.25 unpacked
+
+	int mazeFilledWidth;		// Width of the maze including the walls
+	int mazeFilledHeight;		// Height of the maze including the walls
+
+	int border;					// 1 when SENTINEL_BORDER is set, cells stored around each grid
+	int stride;					// cells per stored row of maze and distances, mazeFilledWidth plus the border, rounded to whole words when packed
+	int attributeStride;		// cells per stored row of mazeAttributes, MAZE_WIDTH plus the border
+	size_t storedCells;			// cells in maze and distances including the border
+	size_t storedAttributes;	// cells in mazeAttributes including the border
+
+	uint32_t largestDistance;	// orthoganal distance from the goal to player
+
+	uint8_t* maze;				// maze with walls, null when PACKED_WALLS is set
+	uint64_t* mazeBits;			// same as the PATH bit of maze, 64 cells per word with every row starting on a new word, null otherwise
+	bool borrowedWalls = false;	// mazeBits points into memory owned by someone else, a mapped MazeFile, and is not deleted
+	uint8_t* mazeAttributes;	// path directions from each maze component to its neighbours and other attributes
+	bool narrowDistances;		// every distance fits in 16 bits, so distances16 is used instead of distances
+	uint32_t* distances;		// orthoganal distance from each cell away from the goal, null when narrowDistances is set
+	uint16_t* distances16;		// same as distances for grids under 65536 cells, null otherwise
+	bool borrowedDistances = false;	// distances or distances16 point into a mapped MazeFile
+	uint32_t* frontier = nullptr;	// Breadth First Search queue of linear cell indices, sized once on first use so solving never allocates, BIT_PARALLEL_BFS floods never need it
+	std::vector<std::vector<uint32_t>> threadFrontiers;	// multithreaded BFS, cells each thread found for the next level
+	uint64_t* frontierBits = nullptr;	// BIT_PARALLEL_BFS current level, same layout as mazeBits, allocated on first use
+	uint64_t* nextBits = nullptr;		// BIT_PARALLEL_BFS next level
+	uint64_t* visitedBits = nullptr;	// BIT_PARALLEL_BFS cells that already have a distance
+	std::vector<uint32_t> activeWords;		// BIT_PARALLEL_BFS words holding the current level
+	std::vector<uint32_t> nextWords;		// BIT_PARALLEL_BFS words holding the next level
+
+	vi2d playerPosition;		// same as a pair, stores x and y coordinates of the player
+	vi2d goalPosition;			// same as a pair, stores x and y coordinates of the goal
+
+	const vi2d directions[4] = { {0, 1}, {-1, 0}, {0, -1}, {1, 0} };	// directions to move in the maze
+
+	enum MazeBits
+	{
+		UP = 0x01,		// 0000 0001, is there a path above this node?
+		LEFT = 0x02,	// 0000 0010, is there a path to the left of this node?
+		DOWN = 0x04,	// 0000 0100, is there a path below this node?
+		RIGHT = 0x08,	// 0000 1000, is there a path to the right of this node?
+		VISITED = 0x10,	// 0001 0000, has this node been visited? reused when generating and solving the maze
+		PATH = 0x20,	// 0010 0000, is this node a path or a wall?
+		PARENT = 0xC0	// 1100 0000, index into directions[], the way back for ITERATIVE_BACKTRACKER and the last step of a WILSON walk
+	};
+
+	static const int PARENT_SHIFT = 6;	// lowest bit of PARENT
+
+	enum GeneratorMode
+	{
+		RECURSIVE_BACKTRACKER,	// one depth first walk from the middle of the maze
+		TILED_BACKTRACKER,		// one walk per GENERATOR_TILE_SIZE tile on its own thread, tiles joined by a random spanning tree
+		ITERATIVE_BACKTRACKER,	// same mazes as RECURSIVE_BACKTRACKER, backtracks through the PARENT bits instead of a stack
+		ELLER,					// one row at a time keeping only a set per column, O(MAZE_WIDTH) extra memory
+		BINARY_TREE,			// every node opens up or right, no state at all, strong diagonal bias
+		SIDEWINDER,				// runs along each row joined upwards once per run, rows only depend on their own random stream
+		KRUSKAL,				// random edge order joined with union-find, short dead ends, 12 bytes per node while carving
+		WILSON					// loop-erased random walks, uniform over every possible maze but the slowest
+	};
+
+	GeneratorMode GENERATOR = RECURSIVE_BACKTRACKER;	// how RandomizeMaze carves mazeAttributes, every mode gives a perfect maze
+	int GENERATOR_THREADS = 0;		// threads for TILED_BACKTRACKER, 0 uses every hardware thread, the maze does not depend on it
+	int GENERATOR_TILE_SIZE = 256;	// width and height of a TILED_BACKTRACKER tile in maze nodes
+
+	enum SolverEngine
+	{
+		SCALAR_BFS,			// one cell at a time from the frontier queue, works with every layout
+		BIT_PARALLEL_BFS	// whole words of the packed grid per step, needs PACKED_WALLS, falls back to SCALAR_BFS otherwise, about 1.2 to 1.8x SCALAR_BFS on mazes but
+							// slower on a grid with MUTATION_RATE 1, where each level is a diagonal with one cell per word, and it costs 3 more bits per cell
+	};
+
+	SolverEngine SOLVER = SCALAR_BFS;	// how FloodDistances fills the distance field, every engine gives the same result
+	int SOLVER_THREADS = 0;				// threads for the scalar BFS on large grids, 0 uses every hardware thread
+	size_t PARALLEL_SOLVE_THRESHOLD = size_t(1) << 22;	// stored cells from which the scalar BFS goes multithreaded, PARALLEL_LEVEL_SIZE keeps the levels of a sparse maze serial so it costs no more than the serial BFS
+	size_t PARALLEL_LEVEL_SIZE = 4096;	// BFS levels smaller than this are expanded by one thread with the serial loop, waking the others costs more
+
+	class WorkerPool	// threads kept between solves, so a BFS level large enough to share only pays a wake up
+	{
+	public:
+		WorkerPool() = default;
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		~WorkerPool()
+		{
+			Resize(1);
+		}
+
+		int Size() const	// threads including the one calling Run
+		{
+			return int(workers.size()) + 1;
+		}
+
+		void Resize(int threads)
+		{
+			if (threads == Size())
+				return;
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				stopping = true;
+				generation++;
+			}
+			wake.notify_all();
+			for (auto& worker : workers)
+				worker.join();
+			workers.clear();
+			stopping = false;
+			for (int thread = 1; thread < threads; thread++)
+				workers.emplace_back([this, thread, seen = generation] { Work(thread, seen); });
+		}
+
+		void Run(const std::function<void(int)>& task)	// task(thread) on every thread, the caller is thread 0, returns when all of them are done
+		{
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				job = &task;
+				pending = workers.size();
+				generation++;
+			}
+			wake.notify_all();
+			task(0);
+			std::unique_lock<std::mutex> guard(lock);
+			done.wait(guard, [this] { return !pending; });
+		}
+
+	private:
+		void Work(int thread, uint64_t seen)
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			while (true)
+			{
+				wake.wait(guard, [&] { return generation != seen; });
+				seen = generation;
+				if (stopping)
+					return;
+				guard.unlock();
+				(*job)(thread);
+				guard.lock();
+				if (!--pending)
+					done.notify_one();
+			}
+		}
+
+		std::vector<std::thread> workers;	// threads 1 and up
+		std::mutex lock;
+		std::condition_variable wake;		// a job was posted or the pool is stopping
+		std::condition_variable done;		// the last worker finished the job
+		const std::function<void(int)>* job = nullptr;
+		uint64_t generation = 0;			// bumped for every job, so a worker never runs one twice
+		size_t pending = 0;					// workers still on the job
+		bool stopping = false;
+	};
+
+	WorkerPool solverPool;	// multithreaded BFS, started on the first level large enough to share
+
+	enum QueryMode
+	{
+		DISTANCE_FIELD,	// flood every reachable cell from the goal with SOLVER, DrawMaze colours the whole maze
+		POINT_TO_POINT,	// bidirectional BFS that stops when the player and goal searches meet, only their cells get a distance
+		ASTAR,			// A* from the goal towards the player with a Manhattan heuristic, stops when the player is taken off the open list
+		JUMP_POINT,		// A* over jump points, straight runs without a branch are skipped in one step
+		LANDMARKS,		// ASTAR steered by landmark distances built once per maze within LANDMARK_BUDGET, for many queries on one maze
+		TREE			// lowest common ancestor on the spanning tree of a maze without loops, no search at all, POINT_TO_POINT when there are loops
+	};
+
+	template <typename Entry>
+	class BucketQueue	// open list for small integer keys, a ring of buckets indexed by key & mask instead of a heap (Dial), A* with a consistent heuristic only holds keys a few above the last one popped
+	{
+	public:
+		std::vector<std::vector<Entry>> buckets;	// ring, a power of two no smaller than the spread of the live keys, so a bucket only ever holds one key, kept allocated between queries
+		size_t cursor = 0;	// no live entry has a smaller key
+		size_t used = 0;	// one past the largest key pushed while entries were live
+		size_t count = 0;	// live entries
+
+		void Clear()
+		{
+			for (auto& bucket : buckets)
+				bucket.clear();
+			cursor = used = count = 0;
+		}
+
+		void Push(Entry entry, size_t key)
+		{
+			if (!count)
+				cursor = used = key;	// nothing live, the window starts over at this key
+			size_t low = std::min(cursor, key);
+			size_t high = std::max(used, key + 1);
+			if (high - low > buckets.size())
+				Grow(high - low);
+			buckets[key & (buckets.size() - 1)].push_back(entry);
+			cursor = low;
+			used = high;
+			count++;
+		}
+
+		bool Pop(Entry& entry, size_t& key)	// the entry with the smallest key, the newest one first among equals
+		{
+			if (!count)
+				return false;
+			const size_t mask = buckets.size() - 1;
+			while (buckets[cursor & mask].empty())
+				cursor++;
+			key = cursor;
+			entry = buckets[cursor & mask].back();
+			buckets[cursor & mask].pop_back();
+			count--;
+			return true;
+		}
+
+	private:
+		void Grow(size_t span)	// a larger ring, only a JUMP_POINT jump can spread the keys further than the last ring covered
+		{
+			size_t size = std::max<size_t>(buckets.size(), 4);
+			while (size < span)
+				size *= 2;
+			std::vector<std::vector<Entry>> grown(size);
+			if (count)
+				for (size_t key = cursor; key < used; key++)
+					grown[key & (size - 1)].swap(buckets[key & (buckets.size() - 1)]);
+			buckets.swap(grown);
+		}
+	};
+
+	QueryMode QUERY = DISTANCE_FIELD;	// what FindShortestPath computes
+	BucketQueue<uint32_t> openCells;	// ASTAR open list of cells
+	std::vector<uint64_t> repairSeeds;	// SetCell, cells a closed cell cut off that still have a way back, distance above the cell so sorting orders them by it
+	BucketQueue<uint64_t> openJumps;	// JUMP_POINT open list, cell in the low 32 bits and the directions[] index it was reached by above them
+	size_t expandedCells = 0;			// cells taken off the open list by the last ASTAR, JUMP_POINT or LANDMARKS query
+	size_t queriedFront = SIZE_MAX;		// POINT_TO_POINT, cells at the start of frontier that the last query gave a distance, SIZE_MAX if any cell may have one
+	size_t queriedBack = 0;				// POINT_TO_POINT, the same for cells at the end of frontier
+
+	bool INCREMENTAL_SOLVE = false;		// DISTANCE_FIELD, serial BFS that stops at the player and keeps its field for the next goal
+	size_t fieldRoot = SIZE_MAX;		// cell the distance field was flooded from, SIZE_MAX when the maze or the field changed since
+	size_t fieldHead = 0;				// serial BFS queue in frontier, left where it stopped so INCREMENTAL_SOLVE can carry on
+	size_t fieldTail = 0;
+
+	size_t LANDMARK_BUDGET = size_t(64) << 20;	// bytes LANDMARKS may spend, each landmark costs 4 bytes per stored cell and one flood to build, building also takes 8 bytes per stored cell of scratch
+	int MAX_LANDMARKS = 16;				// more rarely tighten the bound enough to pay for the extra lookups
+	int landmarkCount = 0;				// landmarks in landmarkDistances, 0 when the budget does not fit one
+	bool landmarksReady = false;		// landmarkDistances belongs to the current maze, cleared by anything that changes the walls
+	uint32_t* landmarkDistances = nullptr;	// distance from every landmark to each cell, landmarkCount values per cell so a lookup is one cache line, allocated on first use
+
+	static const int TREE_BLOCK = 32;	// Euler tour entries per block, the sparse table covers whole blocks and the ends are scanned
+	bool treeReady = false;				// TREE structures belong to the current maze, cleared by anything that changes the walls
+	bool isTree = false;				// the path cells form one tree, so TREE can answer without a search
+	uint32_t* treeDepth = nullptr;		// steps from the tree root to each path cell, UINT32_MAX for walls, allocated on first use
+	uint32_t* treeFirst = nullptr;		// first position of each path cell in eulerTour
+	std::vector<uint32_t> eulerTour;	// cells in depth first order, a cell is listed again each time the walk comes back to it
+	std::vector<uint32_t> tourDepth;	// treeDepth of each eulerTour entry, so the scans stay in one array
+	std::vector<uint32_t> blockMinimum;	// sparse table, level j holds for every block the tour position of the shallowest entry in the next 2^j blocks
+
+	std::vector<vi2d> shortestPath;	// Breadth First Search result, list of nodes to visit to reach the goal
+
+	unsigned int seed;				// scene seed, every random stream below is derived from it
+	unsigned int generationState;	// xorshift state for carving mazeAttributes
+	unsigned int mutationState;		// xorshift state for flipping walls into paths
+	unsigned int placementState;	// xorshift state for placing the player and the goal
+
+	enum RandomStream	// stream numbers passed to MixSeed, never reorder so old seeds keep their mazes
+	{
+		GENERATION_STREAM,
+		MUTATION_STREAM,
+		PLACEMENT_STREAM
+	};
+
+	MazeCore(int MAZE_WIDTH, int MAZE_HEIGHT, int MUTATION_RATE, bool SENTINEL_BORDER = false, bool PACKED_WALLS = false, unsigned int SEED = 0)
+	{
+		if (!Fits(MAZE_WIDTH, MAZE_HEIGHT, SENTINEL_BORDER, PACKED_WALLS))
+			throw std::length_error("maze does not fit 32 bit cell indices");	// they would wrap and the solvers would write out of bounds
+
+		this->MAZE_WIDTH = MAZE_WIDTH;
+		this->MAZE_HEIGHT = MAZE_HEIGHT;
+		this->MUTATION_RATE = MUTATION_RATE;
+		this->SENTINEL_BORDER = SENTINEL_BORDER;
+		this->PACKED_WALLS = PACKED_WALLS;
+
+		mazeFilledWidth = MAZE_WIDTH * 2;	// each node contains the main path and side paths connecting to its neighbours, EX: P = PATH	PW	PP	PW
+		mazeFilledHeight = MAZE_HEIGHT * 2;	// each node contains the main path and side paths connecting to its neighbours, W = WALL		WW	WW	PW
+
+		border = SENTINEL_BORDER;
+		stride = RowStride(mazeFilledWidth, SENTINEL_BORDER, PACKED_WALLS);
+		attributeStride = MAZE_WIDTH + 2 * border;
+		storedCells = size_t(stride) * (mazeFilledHeight + 2 * border);
+		storedAttributes = size_t(attributeStride) * (MAZE_HEIGHT + 2 * border);
+
+		maze = PACKED_WALLS ? nullptr : new uint8_t[storedCells];			// 2x2 nodes, each cell describes a path/wall and if it has been visited during solving
+		mazeBits = PACKED_WALLS ? new uint64_t[storedCells / 64] : nullptr;	// stride is a multiple of 64 so rows pack into whole words
+		mazeAttributes = new uint8_t[storedAttributes];	// each cell describes if it is up, left, down, right, and if it has been visited during generating
+		narrowDistances = storedCells <= UINT16_MAX;	// a distance is always smaller than the number of cells, leaving 0xFFFF free for unreached
+		distances = narrowDistances ? nullptr : new uint32_t[storedCells];	// each cell describes the distance from the player to that cell
+		distances16 = narrowDistances ? new uint16_t[storedCells] : nullptr;
+
+		if (!SEED)	// no seed given, every run is different
+			SEED = unsigned(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count());
+		Reseed(SEED);
+	}
+
+	static bool Fits(int MAZE_WIDTH, int MAZE_HEIGHT, bool SENTINEL_BORDER, bool PACKED_WALLS)	// every stored cell of the layout has a uint32_t index, which frontier and the solvers use
+	{
+		if (MAZE_WIDTH <= 0 || MAZE_WIDTH > INT_MAX / 2 - 64 || MAZE_HEIGHT <= 0 || MAZE_HEIGHT > INT_MAX / 2 - 1)
+			return false;
+		const size_t rows = size_t(MAZE_HEIGHT) * 2 + 2 * SENTINEL_BORDER;
+		return size_t(RowStride(MAZE_WIDTH * 2, SENTINEL_BORDER, PACKED_WALLS)) <= UINT32_MAX / rows;
+	}
+
+	static int RowStride(int mazeFilledWidth, bool SENTINEL_BORDER, bool PACKED_WALLS)	// cells per stored row for a layout
+	{
+		int stride = mazeFilledWidth + 2 * SENTINEL_BORDER;
+		if (PACKED_WALLS)	// keep at least one wall column at the end of each row so word shifts never carry a path into the next row
+			stride = (stride + !SENTINEL_BORDER + 63) & ~63;
+		return stride;
+	}
+
+	MazeCore(const MazeCore&) = delete;
+	MazeCore& operator=(const MazeCore&) = delete;
+
+	virtual ~MazeCore()
+	{
+		delete[] maze;
+		if (!borrowedWalls)
+			delete[] mazeBits;
+		delete[] mazeAttributes;
+		if (!borrowedDistances)
+		{
+			delete[] distances;
+			delete[] distances16;
+		}
+		delete[] frontier;
+		delete[] frontierBits;
+		delete[] nextBits;
+		delete[] visitedBits;
+		delete[] landmarkDistances;
+		delete[] treeDepth;
+		delete[] treeFirst;
+	}
+
+	void AllocateFrontier()	// every cell enters the queue at most once, so it never has to wrap or grow
+	{
+		if (!frontier)
+			frontier = new uint32_t[storedCells];
+	}
+
+	size_t Index(int x, int y) const	// linear index of a maze cell, skipping the border when there is one
+	{
+		return size_t(y + border) * stride + (x + border);
+	}
+
+	size_t AttributeIndex(int x, int y) const	// linear index of a maze node in mazeAttributes
+	{
+		return size_t(y + border) * attributeStride + (x + border);
+	}
+
+	template <typename T>
+	T* DistanceArray() const	// distances or distances16, picked at compile time by the hot loops
+	{
+		if constexpr (sizeof(T) == sizeof(uint16_t))
+			return distances16;
+		else
+			return distances;
+	}
+
+	uint32_t Distance(size_t index) const	// distance of a cell whichever width is stored, UINT32_MAX if it was not reached
+	{
+		if (narrowDistances)
+			return distances16[index] == UINT16_MAX ? UINT32_MAX : distances16[index];
+		return distances[index];
+	}
+
+	template <bool PACKED>
+	bool IsPath(size_t index) const	// every read of the wall grid goes through here so both encodings share the algorithms
+	{
+		if constexpr (PACKED)
+			return (mazeBits[index >> 6] >> (index & 63)) & 1;
+		else
+			return maze[index] & PATH;
+	}
+
+	bool IsPath(size_t index) const
+	{
+		return PACKED_WALLS ? IsPath<true>(index) : IsPath<false>(index);
+	}
+
+	void SetPath(size_t index)	// turn a wall into a path
+	{
+		if (PACKED_WALLS)
+			mazeBits[index >> 6] |= uint64_t(1) << (index & 63);
+		else
+			maze[index] |= PATH;
+	}
+
+	void ClearPath(size_t index)	// turn a path into a wall
+	{
+		if (PACKED_WALLS)
+			mazeBits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+		else
+			maze[index] &= ~PATH;
+	}
+
+	void ClearPaths()	// turn every cell into a wall
+	{
+		ClearPaths(0, mazeFilledHeight + 2 * border);
+	}
+
+	void ClearPaths(size_t firstRow, size_t lastRow)	// turn every cell of the stored rows [firstRow, lastRow) into a wall, rows never share a word
+	{
+		if (PACKED_WALLS)
+			memset(mazeBits + firstRow * (stride / 64), 0, sizeof(uint64_t) * (lastRow - firstRow) * (stride / 64));
+		else
+			memset(maze + firstRow * stride, 0, sizeof(uint8_t) * (lastRow - firstRow) * stride);
+	}
+
+	vi2d Position(size_t index) const	// inverse of Index
+	{
+		return { int(index % stride) - border, int(index / stride) - border };
+	}
+
+	void Reseed(unsigned int seed)	// restart every stream, the same seed replays the same scenes whatever engines are picked
+	{
+		this->seed = seed;
+		generationState = MixSeed(seed, GENERATION_STREAM);
+		mutationState = MixSeed(seed, MUTATION_STREAM);
+		placementState = MixSeed(seed, PLACEMENT_STREAM);
+	}
+
+	static unsigned int XorShift32(unsigned int& state)	//xorshift32, each stage keeps its own state so changing one stage leaves the others alone
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	static unsigned int MixSeed(unsigned int base, unsigned int stream)	// independent, never zero xorshift seed for one stream of a base seed
+	{
+		uint64_t z = (uint64_t(base) << 32 | stream) + 0x9E3779B97F4A7C15ull;	// splitmix64 finaliser
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		z ^= z >> 31;
+		return unsigned(z) | 1;
+	}
+
+	void RandomizeMaze()
+	{
+		fieldRoot = SIZE_MAX;	// the old field belongs to the old maze
+		landmarksReady = false;
+		treeReady = false;
+		if (GENERATOR == TILED_BACKTRACKER)
+		{
+			GenerateTiles();	// clears, carves and expands tile by tile on every thread
+			return;
+		}
+
+		ClearPaths();													// set all cells to no path
+		memset(mazeAttributes, 0, sizeof(uint8_t) * storedAttributes);	// set all cells to no connections and not visited
+		MarkBorder();
+
+		switch (GENERATOR)
+		{
+		case ITERATIVE_BACKTRACKER: SENTINEL_BORDER ? CarveMazeIterative<true>() : CarveMazeIterative<false>(); break;
+		case ELLER: CarveEller(); break;
+		case BINARY_TREE: CarveBinaryTree(); break;
+		case SIDEWINDER: CarveSidewinder(); break;
+		case KRUSKAL: CarveKruskal(); break;
+		case WILSON: CarveWilson(); break;
+		default: SENTINEL_BORDER ? CarveMaze<true>() : CarveMaze<false>(); break;
+		}
+
+		if (GENERATOR == ELLER)	// row order like MazeStream, which cannot go back over a row, so a stream with the same seed writes the same maze mutations included
+		{
+			for (int y = 0; y < MAZE_HEIGHT; y++)
+				for (int x = 0; x < MAZE_WIDTH; x++)
+					ExpandNode(x, y, mutationState);
+		}
+		else	// the original order, so seeds of the other generators keep their mazes
+		{
+			for (int x = MAZE_WIDTH; x--;)
+				for (int y = MAZE_HEIGHT; y--;)
+					ExpandNode(x, y, mutationState);
+		}
+	}
+
+	void MarkBorder()	// mark the border as visited so the generator never walks onto it
+	{
+		if (!SENTINEL_BORDER)
+			return;
+		for (int x = -1; x <= MAZE_WIDTH; x++)
+			mazeAttributes[AttributeIndex(x, -1)] = mazeAttributes[AttributeIndex(x, MAZE_HEIGHT)] = VISITED;
+		for (int y = 0; y < MAZE_HEIGHT; y++)
+			mazeAttributes[AttributeIndex(-1, y)] = mazeAttributes[AttributeIndex(MAZE_WIDTH, y)] = VISITED;
+	}
+
+	void ExpandNode(int x, int y, unsigned int& state)	// one node into its 2x2 cells, mutations drawn from state in the order the nodes are visited
+	{
+		int mazex = x << 1;	// convert to cell space
+		int mazey = y << 1;	// convert to cell space
+
+		SetPath(Index(mazex, mazey));														// set the center cell to path
+		if (mazeAttributes[AttributeIndex(x, y)] & UP || (MUTATION_RATE > 0 && XorShift32(state) % MUTATION_RATE == 0))	// if the cell has a path up or if it is a mutation
+			SetPath(Index(mazex, mazey + 1));												// set the top cell to path
+		if (mazeAttributes[AttributeIndex(x, y)] & RIGHT || (MUTATION_RATE > 0 && XorShift32(state) % MUTATION_RATE == 0))	// if the cell has a path right or if it is a mutation
+			SetPath(Index(mazex + 1, mazey));												// set the right cell to path
+	}
+
+	template <bool BORDER>
+	void CarveMaze()	// recursive backtracker, BORDER skips the edge checks because the sentinel cells are already visited
+	{
+		const int offsets[4] = { attributeStride, -1, -attributeStride, 1 };	// directions[] as linear offsets
+
+		std::vector<vi2d> stack;
+		stack.push_back({ MAZE_WIDTH / 2, MAZE_HEIGHT / 2 });					// start at the middle of the maze
+
+		vi2d nextPos;
+		std::vector<uint8_t> neighbours;
+		while (!stack.empty())
+		{
+			neighbours.clear();
+			vi2d current = stack.back();
+			size_t currentIndex = AttributeIndex(current.x, current.y);
+			mazeAttributes[currentIndex] |= VISITED;		// mark current node as visited
+
+			for (int i = 4; i--;)
+			{
+				nextPos = current + directions[i];	// get the next position in the direction
+				if ((BORDER || (nextPos.x >= 0 && nextPos.x < MAZE_WIDTH && nextPos.y >= 0 && nextPos.y < MAZE_HEIGHT)) && !(mazeAttributes[currentIndex + offsets[i]] & VISITED))
+					neighbours.push_back(i);	// if the next position is within the maze and has not been visited, add it to the list of neighbours
+			}
+
+			if (neighbours.empty())
+				stack.pop_back();	// if there are no neighbours, backtrack
+			else
+			{
+				int direction = neighbours[XorShift32(generationState) % neighbours.size()];	// pick a random neighbour
+				nextPos = current + directions[direction];
+
+				mazeAttributes[currentIndex] |= (1 << direction);	// set the direction bit to 1, reference MazeBits
+				mazeAttributes[currentIndex + offsets[direction]] |= (1 << ((direction + 2) & 3));	// set the opposite direction bit to 1, reference MazeBits
+				stack.push_back(nextPos);			// add the new cell to the stack
+			}
+		}
+	}
+
+	template <bool BORDER>
+	void CarveMazeIterative()	// ITERATIVE_BACKTRACKER, no allocation, the walk back is stored in the PARENT bits of each node
+	{
+		const int offsets[4] = { attributeStride, -1, -attributeStride, 1 };	// directions[] as linear offsets
+
+		vi2d current = { MAZE_WIDTH / 2, MAZE_HEIGHT / 2 };	// start at the middle of the maze
+		const size_t start = AttributeIndex(current.x, current.y);
+		size_t currentIndex = start;
+		mazeAttributes[start] |= VISITED;
+
+		for (;;)
+		{
+			unsigned int open = 0;	// bit i is set when directions[i] leads to a node that has not been visited
+			for (int i = 4; i--;)
+			{
+				vi2d nextPos = current + directions[i];
+				if ((BORDER || (nextPos.x >= 0 && nextPos.x < MAZE_WIDTH && nextPos.y >= 0 && nextPos.y < MAZE_HEIGHT)) && !(mazeAttributes[currentIndex + offsets[i]] & VISITED))
+					open |= 1u << i;
+			}
+
+			if (!open)
+			{
+				if (currentIndex == start)
+					break;			// back at the start with nothing left to visit
+				int parent = (mazeAttributes[currentIndex] & PARENT) >> PARENT_SHIFT;
+				current = current + directions[parent];	// backtrack
+				currentIndex += offsets[parent];
+				continue;
+			}
+
+			int count = std::popcount(open);
+			for (int skip = count - 1 - int(XorShift32(generationState) % count); skip--;)
+				open &= open - 1;	// drop the lowest bits, CarveMaze lists directions from 3 down so both pick the same one
+			int direction = std::countr_zero(open);
+			int back = (direction + 2) & 3;
+
+			mazeAttributes[currentIndex] |= (1 << direction);	// set the direction bit to 1, reference MazeBits
+			current = current + directions[direction];
+			currentIndex += offsets[direction];
+			mazeAttributes[currentIndex] |= VISITED | (1 << back) | (back << PARENT_SHIFT);	// open the way back and remember it
+		}
+	}
+
+	void CarveRegion(int left, int top, int right, int bottom, unsigned int& state)	// recursive backtracker that never leaves [left, right) x [top, bottom)
+	{
+		std::vector<vi2d> stack;
+		stack.push_back({ (left + right) / 2, (top + bottom) / 2 });	// start at the middle of the region
+
+		vi2d nextPos;
+		int neighbours[4];
+		while (!stack.empty())
+		{
+			int neighbourCount = 0;
+			vi2d current = stack.back();
+			size_t currentIndex = AttributeIndex(current.x, current.y);
+			mazeAttributes[currentIndex] |= VISITED;		// mark current node as visited
+
+			for (int i = 4; i--;)
+			{
+				nextPos = current + directions[i];	// get the next position in the direction
+				if (nextPos.x >= left && nextPos.x < right && nextPos.y >= top && nextPos.y < bottom && !(mazeAttributes[AttributeIndex(nextPos.x, nextPos.y)] & VISITED))
+					neighbours[neighbourCount++] = i;	// if the next position is within the region and has not been visited, add it to the list of neighbours
+			}
+
+			if (!neighbourCount)
+				stack.pop_back();	// if there are no neighbours, backtrack
+			else
+			{
+				int direction = neighbours[XorShift32(state) % neighbourCount];	// pick a random neighbour
+				nextPos = current + directions[direction];
+				Connect(current, direction);
+				stack.push_back(nextPos);			// add the new cell to the stack
+			}
+		}
+	}
+
+	void Connect(vi2d node, int direction)	// open the passage from a node to its neighbour in directions[direction], reference MazeBits
+	{
+		vi2d nextPos = node + directions[direction];
+		mazeAttributes[AttributeIndex(node.x, node.y)] |= (1 << direction);
+		mazeAttributes[AttributeIndex(nextPos.x, nextPos.y)] |= (1 << ((direction + 2) & 3));
+	}
+
+	void GenerateTiles()	// TILED_BACKTRACKER, tiles are seeded by their position so the maze does not depend on the thread count
+	{
+		const int tileSize = GENERATOR_TILE_SIZE > 0 ? GENERATOR_TILE_SIZE : 1;
+		const int tilesWide = (MAZE_WIDTH + tileSize - 1) / tileSize;
+		const int tilesHigh = (MAZE_HEIGHT + tileSize - 1) / tileSize;
+		const int tiles = tilesWide * tilesHigh;
+		const unsigned int base = XorShift32(generationState);
+		const unsigned int mutationBase = XorShift32(mutationState);	// each tile draws its mutations from its own stream, so the expand runs in the workers too
+
+		int threads = GENERATOR_THREADS > 0 ? GENERATOR_THREADS : int(std::thread::hardware_concurrency());
+		auto parallel = [&](int jobs, auto job)	// job(i) for every i below jobs, taken in turn by the threads
+		{
+			std::atomic<int> nextJob(0);
+			auto work = [&]
+			{
+				for (int i; (i = nextJob.fetch_add(1, std::memory_order_relaxed)) < jobs;)
+					job(i);
+			};
+			std::vector<std::thread> workers;
+			for (int thread = 1; thread < std::min(threads, jobs); thread++)
+				workers.emplace_back(work);
+			work();
+			for (auto& worker : workers)
+				worker.join();
+		};
+
+		parallel(tiles, [&](int tile)	// tiles never share a node, so no locking
+		{
+			int left = tile % tilesWide * tileSize;
+			int top = tile / tilesWide * tileSize;
+			int right = std::min(left + tileSize, MAZE_WIDTH);
+			int bottom = std::min(top + tileSize, MAZE_HEIGHT);
+			for (int y = top; y < bottom; y++)
+				memset(mazeAttributes + AttributeIndex(left, y), 0, sizeof(uint8_t) * (right - left));	// set the tile to no connections and not visited
+			unsigned int state = MixSeed(base, tile);
+			CarveRegion(left, top, right, bottom, state);
+		});
+		MarkBorder();
+
+		// every tile is a perfect maze, so joining them along a spanning tree of the tile grid keeps the whole maze perfect
+		std::vector<int> edges;	// tile * 2 joins to the tile on the right, tile * 2 + 1 to the tile below
+		for (int tile = 0; tile < tiles; tile++)
+		{
+			if (tile % tilesWide + 1 < tilesWide)
+				edges.push_back(tile * 2);
+			if (tile / tilesWide + 1 < tilesHigh)
+				edges.push_back(tile * 2 + 1);
+		}
+		for (int i = int(edges.size()); i > 1; i--)	// shuffle, then take edges in order while they join two trees (Kruskal)
+			std::swap(edges[i - 1], edges[XorShift32(generationState) % i]);
+
+		std::vector<int> parent(tiles);
+		for (int tile = 0; tile < tiles; tile++)
+			parent[tile] = tile;
+		auto root = [&](int tile)
+		{
+			while (parent[tile] != tile)
+				tile = parent[tile] = parent[parent[tile]];	// path halving
+			return tile;
+		};
+
+		for (int edge : edges)
+		{
+			int tile = edge / 2;
+			bool below = edge & 1;
+			int other = tile + (below ? tilesWide : 1);
+			int a = root(tile);
+			int b = root(other);
+			if (a == b)
+				continue;
+			parent[a] = b;
+
+			int left = tile % tilesWide * tileSize;
+			int top = tile / tilesWide * tileSize;
+			if (below)	// open a random node on the shared edge, UP is +y in directions[]
+			{
+				int span = std::min(left + tileSize, MAZE_WIDTH) - left;
+				Connect({ left + int(XorShift32(generationState) % span), top + tileSize - 1 }, 0);
+			}
+			else
+			{
+				int span = std::min(top + tileSize, MAZE_HEIGHT) - top;
+				Connect({ left + tileSize - 1, top + int(XorShift32(generationState) % span) }, 3);
+			}
+		}
+
+		parallel(tilesHigh, [&](int row)	// whole rows of tiles after the joins, packed rows start on a new word so no two threads write the same one
+		{
+			int top = row * tileSize;
+			int bottom = std::min(top + tileSize, MAZE_HEIGHT);
+			ClearPaths(row ? size_t(top) * 2 + border : 0, row + 1 < tilesHigh ? size_t(bottom) * 2 + border : size_t(mazeFilledHeight) + 2 * border);	// the first and last rows take the border too
+			for (int tile = row * tilesWide; tile < (row + 1) * tilesWide; tile++)
+			{
+				int left = tile % tilesWide * tileSize;
+				int right = std::min(left + tileSize, MAZE_WIDTH);
+				unsigned int state = MixSeed(mutationBase, tile);
+				for (int x = right; x-- > left;)
+					for (int y = bottom; y-- > top;)
+						ExpandNode(x, y, state);
+			}
+		});
+	}
+
+	class EllerRows	// Eller's algorithm one row of maze nodes at a time, nodes in a row that are already joined share a set
+	{
+	public:
+		std::vector<int> set;		// union-find over the columns of the current row, a root is the leftmost column of its set
+		std::vector<int> nextSet;	// the same for the row above
+		std::vector<int> firstUp;	// per root, first column of the set that opened up, -1 if none yet
+		std::vector<int> seen;		// per root, columns of the set seen so far
+		std::vector<int> chosen;	// per root, column that is forced up so the set carries on
+
+		EllerRows(int width) : set(width), nextSet(width), firstUp(width), seen(width), chosen(width)
+		{
+			for (int x = 0; x < width; x++)
+				set[x] = x;	// every node of the first row starts in a set of its own
+		}
+
+		int Root(int x)
+		{
+			while (set[x] != x)
+				x = set[x] = set[set[x]];	// path halving
+			return x;
+		}
+
+		template <typename Open>
+		void Row(bool lastRow, unsigned int& state, Open open)	// calls open(x, 3) for each passage right and open(x, 0) for each passage up, then moves up a row
+		{
+			const int width = int(set.size());
+			for (int x = 0; x + 1 < width; x++)	// join neighbours in different sets, always on the last row so the maze is connected
+			{
+				int a = Root(x);
+				int b = Root(x + 1);
+				if (a != b && (lastRow || XorShift32(state) & 1))
+				{
+					set[std::max(a, b)] = std::min(a, b);
+					open(x, 3);
+				}
+			}
+			if (lastRow)
+				return;
+
+			for (int x = 0; x < width; x++)	// pick one node per set at random that has to open up
+			{
+				int r = Root(x);
+				seen[r] = r == x ? 1 : seen[r] + 1;
+				if (r == x || XorShift32(state) % seen[r] == 0)
+					chosen[r] = x;
+				firstUp[r] = -1;
+			}
+			for (int x = 0; x < width; x++)	// open up, nodes above that did not get a passage start new sets
+			{
+				int r = Root(x);
+				if (chosen[r] == x || XorShift32(state) & 1)
+				{
+					open(x, 0);
+					if (firstUp[r] < 0)
+						firstUp[r] = x;
+					nextSet[x] = firstUp[r];
+				}
+				else
+					nextSet[x] = x;
+			}
+			std::swap(set, nextSet);
+		}
+	};
+
+	void CarveEller()	// ELLER, rows below the current one are never read again, so this is the same walk MazeStream writes to disk
+	{
+		EllerRows rows(MAZE_WIDTH);
+		for (int y = 0; y < MAZE_HEIGHT; y++)
+			rows.Row(y == MAZE_HEIGHT - 1, generationState, [&](int x, int direction) { Connect({ x, y }, direction); });
+	}
+
+	void CarveBinaryTree()	// BINARY_TREE, each node opens up or right at random, along the last row and column only one choice is left
+	{
+		for (int y = 0; y < MAZE_HEIGHT; y++)
+		{
+			for (int x = 0; x < MAZE_WIDTH; x++)
+			{
+				bool up = y + 1 < MAZE_HEIGHT;
+				bool right = x + 1 < MAZE_WIDTH;
+				if (up && right)
+					Connect({ x, y }, XorShift32(generationState) & 1 ? 0 : 3);
+				else if (up || right)
+					Connect({ x, y }, up ? 0 : 3);
+			}
+		}
+	}
+
+	void CarveSidewinder()	// SIDEWINDER, the last row is one long corridor, every other row is cut into runs that each open up once
+	{
+		const unsigned int base = XorShift32(generationState);
+		for (int y = 0; y < MAZE_HEIGHT; y++)
+		{
+			unsigned int state = MixSeed(base, y);	// a row never reads another row, so rows could be carved in any order
+			int runStart = 0;
+			for (int x = 0; x < MAZE_WIDTH; x++)
+			{
+				bool lastRow = y == MAZE_HEIGHT - 1;
+				if (!lastRow && (x == MAZE_WIDTH - 1 || XorShift32(state) & 1))
+				{
+					Connect({ runStart + int(XorShift32(state) % (x - runStart + 1)), y }, 0);	// close the run
+					runStart = x + 1;
+				}
+				else if (x + 1 < MAZE_WIDTH)
+					Connect({ x, y }, 3);
+			}
+		}
+	}
+
+	void CarveKruskal()	// KRUSKAL, every passage between two nodes in a random order, kept when it joins two trees
+	{
+		const uint32_t nodes = uint32_t(MAZE_WIDTH) * MAZE_HEIGHT;
+		std::vector<uint32_t> edges;	// node * 2 joins to the node on the right, node * 2 + 1 to the node above
+		edges.reserve(size_t(nodes) * 2);
+		for (uint32_t node = 0; node < nodes; node++)
+		{
+			if (node % MAZE_WIDTH + 1 < uint32_t(MAZE_WIDTH))
+				edges.push_back(node * 2);
+			if (node / MAZE_WIDTH + 1 < uint32_t(MAZE_HEIGHT))
+				edges.push_back(node * 2 + 1);
+		}
+		for (size_t i = edges.size(); i > 1; i--)	// Fisher-Yates shuffle
+			std::swap(edges[i - 1], edges[XorShift32(generationState) % i]);
+
+		std::vector<uint32_t> parent(nodes);
+		for (uint32_t node = 0; node < nodes; node++)
+			parent[node] = node;
+		auto root = [&](uint32_t node)
+		{
+			while (parent[node] != node)
+				node = parent[node] = parent[parent[node]];	// path halving
+			return node;
+		};
+
+		uint32_t joined = 1;
+		for (uint32_t edge : edges)
+		{
+			uint32_t node = edge / 2;
+			bool up = edge & 1;
+			uint32_t a = root(node);
+			uint32_t b = root(node + (up ? MAZE_WIDTH : 1));
+			if (a == b)
+				continue;
+			parent[a] = b;
+			Connect({ int(node % MAZE_WIDTH), int(node / MAZE_WIDTH) }, up ? 0 : 3);
+			if (++joined == nodes)
+				break;	// spanning tree complete, the remaining edges would all close loops
+		}
+	}
+
+	void CarveWilson()	// WILSON, random walks from each node outside the maze until they hit it, loops are erased by overwriting the step taken
+	{
+		mazeAttributes[AttributeIndex(MAZE_WIDTH / 2, MAZE_HEIGHT / 2)] |= VISITED;	// the maze starts as a single node
+
+		for (int y = 0; y < MAZE_HEIGHT; y++)
+		{
+			for (int x = 0; x < MAZE_WIDTH; x++)
+			{
+				if (mazeAttributes[AttributeIndex(x, y)] & VISITED)
+					continue;
+
+				vi2d current = { x, y };
+				while (!(mazeAttributes[AttributeIndex(current.x, current.y)] & VISITED))	// walk, remembering only the last step out of each node
+				{
+					unsigned int open = (current.y + 1 < MAZE_HEIGHT) | (current.x > 0) << 1 | (current.y > 0) << 2 | (current.x + 1 < MAZE_WIDTH) << 3;
+					for (int skip = int(XorShift32(generationState) % std::popcount(open)); skip--;)
+						open &= open - 1;
+					int direction = std::countr_zero(open);
+					uint8_t& attributes = mazeAttributes[AttributeIndex(current.x, current.y)];
+					attributes = uint8_t((attributes & ~PARENT) | direction << PARENT_SHIFT);
+					current = current + directions[direction];
+				}
+
+				current = { x, y };
+				while (!(mazeAttributes[AttributeIndex(current.x, current.y)] & VISITED))	// retrace the loop-erased walk into the maze
+				{
+					uint8_t& attributes = mazeAttributes[AttributeIndex(current.x, current.y)];
+					int direction = (attributes & PARENT) >> PARENT_SHIFT;
+					attributes |= VISITED;
+					Connect(current, direction);
+					current = current + directions[direction];
+				}
+			}
+		}
+	}
+
+	void RandomizePlayer()
+	{
+		do
+		{	// randomize player position
+			playerPosition = { int(XorShift32(placementState) % mazeFilledWidth), int(XorShift32(placementState) % mazeFilledHeight) };
+		} while (!(IsPath(Index(playerPosition.x, playerPosition.y)) || goalPosition == playerPosition));
+	}
+
+	void RandomizeGoal()
+	{
+		do
+		{	// randomize goal position
+			goalPosition = { int(XorShift32(placementState) % mazeFilledWidth), int(XorShift32(placementState) % mazeFilledHeight) };
+		} while (!(IsPath(Index(goalPosition.x, goalPosition.y)) || goalPosition == playerPosition));
+	}
+
+	void FindShortestPath()	// Breadth First Search
+	{
+		while (!(IsPath(Index(playerPosition.x, playerPosition.y))))
+		{
+			RandomizePlayer();	// ensure player is on a path
+		}
+		while (!(IsPath(Index(goalPosition.x, goalPosition.y))))
+		{
+			RandomizeGoal();	// ensure goal is on a path
+		}
+
+		if (QUERY != DISTANCE_FIELD)
+		{
+			fieldRoot = SIZE_MAX;	// the queries leave only part of a field
+			if (narrowDistances)
+				PACKED_WALLS ? FindPath<true, uint16_t>() : FindPath<false, uint16_t>();
+			else
+				PACKED_WALLS ? FindPath<true, uint32_t>() : FindPath<false, uint32_t>();
+			return;
+		}
+
+		if (!INCREMENTAL_SOLVE && FieldComplete())
+		{
+			FinishQuery();	// the field is complete and still rooted at the goal, SetCell keeps it that way
+			return;
+		}
+
+		if (INCREMENTAL_SOLVE)
+		{
+			if (narrowDistances)
+				PACKED_WALLS ? (SENTINEL_BORDER ? SolveIncremental<true, true, uint16_t>() : SolveIncremental<true, false, uint16_t>())
+					: (SENTINEL_BORDER ? SolveIncremental<false, true, uint16_t>() : SolveIncremental<false, false, uint16_t>());
+			else
+				PACKED_WALLS ? (SENTINEL_BORDER ? SolveIncremental<true, true, uint32_t>() : SolveIncremental<true, false, uint32_t>())
+					: (SENTINEL_BORDER ? SolveIncremental<false, true, uint32_t>() : SolveIncremental<false, false, uint32_t>());
+			return;
+		}
+
+		FloodDistances();	// distance from the goal to every reachable cell
+		FinishQuery();		// walk the distances back from the player to the goal
+	}
+
+	bool FieldComplete() const	// the distance field is a whole flood from the current goal, not part of a query or a flood that stopped at the player
+	{
+		return fieldRoot == Index(goalPosition.x, goalPosition.y) && fieldHead == fieldTail;
+	}
+
+	void FloodDistances()	// Breadth First Search from the goal
+	{
+		queriedFront = SIZE_MAX;	// every cell gets written
+		fieldRoot = Index(goalPosition.x, goalPosition.y);
+		fieldHead = fieldTail = 0;	// complete, nothing left to resume
+		if (SOLVER == BIT_PARALLEL_BFS && PACKED_WALLS)
+			narrowDistances ? FloodDistancesBitParallel<uint16_t>() : FloodDistancesBitParallel<uint32_t>();
+		else if (PACKED_WALLS)
+			FloodDistances<true>();
+		else
+			FloodDistances<false>();
+	}
+
+	template <bool PACKED>
+	void FloodDistances()
+	{
+		AllocateFrontier();
+		int threads = SOLVER_THREADS > 0 ? SOLVER_THREADS : int(std::thread::hardware_concurrency());
+		if (threads > 1 && storedCells >= PARALLEL_SOLVE_THRESHOLD)
+		{
+			if (narrowDistances)
+				SENTINEL_BORDER ? FloodDistancesParallel<PACKED, true, uint16_t>(threads) : FloodDistancesParallel<PACKED, false, uint16_t>(threads);
+			else
+				SENTINEL_BORDER ? FloodDistancesParallel<PACKED, true, uint32_t>(threads) : FloodDistancesParallel<PACKED, false, uint32_t>(threads);
+		}
+		else if (narrowDistances)
+			SENTINEL_BORDER ? FloodDistances<PACKED, true, uint16_t>() : FloodDistances<PACKED, false, uint16_t>();
+		else
+			SENTINEL_BORDER ? FloodDistances<PACKED, true, uint32_t>() : FloodDistances<PACKED, false, uint32_t>();
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void FloodDistances()	// PACKED reads mazeBits, BORDER relies on the wall around the grid instead of checking the edges, T is the stored distance type
+	{
+		StartFlood<T>(Index(goalPosition.x, goalPosition.y));
+		ExpandFlood<PACKED, BORDER, T>(SIZE_MAX);
+	}
+
+	template <typename T>
+	void StartFlood(size_t root)	// serial BFS from root, ExpandFlood does the work and can be called again to carry on
+	{
+		T* distances = DistanceArray<T>();
+		AllocateFrontier();
+		ResetQueriedDistances<T>();	// only the cells the last serial flood or query reached, unless something else wrote the field
+		distances[root] = 0;		// set the root distance to 0
+		frontier[0] = uint32_t(root);	// add the root to the queue
+		fieldRoot = root;
+		fieldHead = 0;
+		fieldTail = 1;
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void ExpandFlood(size_t target)	// carry on the flood from StartFlood until target has a distance, SIZE_MAX floods everything reachable
+	{
+		if (fieldHead == fieldTail)
+			return;	// complete, and a field from BIT_PARALLEL_BFS, the threaded BFS or a repair is not listed in frontier for queriedFront
+		T* distances = DistanceArray<T>();
+		size_t head = fieldHead;	// next cell to expand
+		size_t tail = fieldTail;	// next free slot in the frontier
+		const bool early = target < storedCells;
+
+		while (head < tail && !(early && distances[target] != T(-1)))
+			ExpandSerial<PACKED, BORDER>(frontier[head++], distances, tail);
+
+		fieldHead = head;
+		fieldTail = tail;
+		queriedFront = tail;	// every cell with a distance is in frontier[0, tail)
+		queriedBack = 0;
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void ExpandSerial(uint32_t current, T* distances, size_t& tail)	// one step of the serial BFS, queues the unreached open neighbours of a cell at frontier[tail]
+	{
+		int x = 0;
+		int y = 0;
+		if (!BORDER)
+		{
+			x = current % stride;		// only needed for the edge checks
+			y = current / stride;
+		}
+		T nextDistance = distances[current] + 1;
+
+		// same order as directions[], checking the edge before stepping off the grid
+		if ((BORDER || x < mazeFilledWidth - 1) && distances[current + 1] == T(-1) && IsPath<PACKED>(current + 1))
+		{
+			distances[current + 1] = nextDistance;
+			frontier[tail++] = current + 1;
+		}
+		if ((BORDER || y > 0) && distances[current - stride] == T(-1) && IsPath<PACKED>(current - stride))
+		{
+			distances[current - stride] = nextDistance;
+			frontier[tail++] = current - stride;
+		}
+		if ((BORDER || x > 0) && distances[current - 1] == T(-1) && IsPath<PACKED>(current - 1))
+		{
+			distances[current - 1] = nextDistance;
+			frontier[tail++] = current - 1;
+		}
+		if ((BORDER || y < mazeFilledHeight - 1) && distances[current + stride] == T(-1) && IsPath<PACKED>(current + stride))
+		{
+			distances[current + stride] = nextDistance;
+			frontier[tail++] = current + stride;
+		}
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void SolveIncremental()	// INCREMENTAL_SOLVE, the field is flooded from the goal, so once the player walks there the next goal only needs a walk back
+	{
+		T* distances = DistanceArray<T>();
+		const size_t goal = Index(goalPosition.x, goalPosition.y);
+		const size_t player = Index(playerPosition.x, playerPosition.y);
+
+		if (fieldRoot != player)
+		{
+			if (fieldRoot != goal)
+				StartFlood<T>(goal);
+			ExpandFlood<PACKED, BORDER, T>(player);	// stop as soon as the player has a distance, the rest is flooded later if a goal needs it
+			FinishQuery<T>();
+			return;
+		}
+
+		ExpandFlood<PACKED, BORDER, T>(goal);	// the field is rooted under the player, usually the goal is already in it
+		if (distances[goal] == T(-1))
+		{
+			largestDistance = 0;	// the goal cannot be reached
+			shortestPath.clear();
+			return;
+		}
+
+		largestDistance = distances[goal];		// walk from the goal down to the player, shortestPath[i] is the cell i steps from the goal
+		shortestPath.resize(largestDistance);
+		vi2d current = goalPosition;
+		vi2d nextPos;
+		for (uint32_t i = 0; i < largestDistance; i++)
+		{
+			shortestPath[i] = current;
+			size_t currentIndex = Index(current.x, current.y);
+			for (int j = 4; j--;)
+			{
+				nextPos = current + directions[j];
+				if ((BORDER || (nextPos.x >= 0 && nextPos.x < mazeFilledWidth && nextPos.y >= 0 && nextPos.y < mazeFilledHeight)) && distances[Index(nextPos.x, nextPos.y)] == T(distances[currentIndex] - 1))
+					break;				// move to the next position with the lowest distance
+			}
+			current = nextPos;
+		}
+	}
+
+	bool SetCell(int x, int y, bool path)	// open or close one cell at runtime, a complete distance field is repaired around it instead of flooded again
+	{
+		if (x < 0 || x >= mazeFilledWidth || y < 0 || y >= mazeFilledHeight)
+			return false;
+		const size_t cell = Index(x, y);
+		if (IsPath(cell) == path)
+			return false;
+		path ? SetPath(cell) : ClearPath(cell);
+		landmarksReady = false;	// an opened cell can shorten distances, which would make the landmark bounds overestimate
+		treeReady = false;
+
+		if (fieldRoot == SIZE_MAX)
+			return true;	// no field to keep
+		if (fieldHead != fieldTail || cell == fieldRoot)
+		{
+			fieldRoot = SIZE_MAX;	// an INCREMENTAL_SOLVE field that stopped early or lost its root, the next solve floods again
+			return true;
+		}
+
+		AllocateFrontier();	// the field may come from BIT_PARALLEL_BFS
+		if (narrowDistances)
+			PACKED_WALLS ? (SENTINEL_BORDER ? RepairDistances<true, true, uint16_t>(cell, path) : RepairDistances<true, false, uint16_t>(cell, path))
+				: (SENTINEL_BORDER ? RepairDistances<false, true, uint16_t>(cell, path) : RepairDistances<false, false, uint16_t>(cell, path));
+		else
+			PACKED_WALLS ? (SENTINEL_BORDER ? RepairDistances<true, true, uint32_t>(cell, path) : RepairDistances<true, false, uint32_t>(cell, path))
+				: (SENTINEL_BORDER ? RepairDistances<false, true, uint32_t>(cell, path) : RepairDistances<false, false, uint32_t>(cell, path));
+		queriedFront = SIZE_MAX;	// the repair used frontier and may have reached cells the flood did not
+		fieldHead = fieldTail = 0;
+		return true;
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void RepairDistances(uint32_t cell, bool opened)	// SetCell, only the cells whose distance changes are visited
+	{
+		T* distances = DistanceArray<T>();
+		uint32_t neighbours[4];
+		uint32_t next[4];
+
+		if (opened)	// distances can only drop, a BFS from the new cell lowers every cell it now gives a shorter way
+		{
+			T best = T(-1);
+			for (int i = OpenNeighbours<PACKED, BORDER>(cell, neighbours); i--;)
+				if (distances[neighbours[i]] != T(-1))
+					best = std::min(best, T(distances[neighbours[i]] + 1));
+			if (best == T(-1))
+				return;		// still cut off from the root
+
+			distances[cell] = best;
+			size_t head = 0;
+			size_t tail = 0;
+			frontier[tail++] = cell;
+			while (head < tail)
+			{
+				uint32_t current = frontier[head++];
+				T nextDistance = distances[current] + 1;
+				for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i--;)
+					if (distances[neighbours[i]] > nextDistance)	// unreached cells hold the largest value
+					{
+						distances[neighbours[i]] = nextDistance;
+						frontier[tail++] = neighbours[i];
+					}
+			}
+			return;
+		}
+
+		T level = distances[cell];
+		distances[cell] = T(-1);
+		if (level == T(-1))
+			return;		// nothing was reached through it
+
+		// closed, a level by level walk from the cell collects the cells whose every shortest way to the root went through it,
+		// their distances are cleared so a cell one level further keeps its distance if any neighbour still has the level below
+		size_t head = 0;
+		size_t tail = 0;
+		frontier[tail++] = cell;
+		while (head < tail)
+		{
+			for (size_t levelEnd = tail; head < levelEnd; head++)
+			{
+				for (int i = OpenNeighbours<PACKED, BORDER>(frontier[head], neighbours); i--;)
+				{
+					uint32_t child = neighbours[i];
+					if (distances[child] != T(level + 1))
+						continue;
+					bool supported = false;
+					for (int j = OpenNeighbours<PACKED, BORDER>(child, next); j-- && !supported;)
+						supported = distances[next[j]] == level;
+					if (!supported)
+					{
+						distances[child] = T(-1);
+						frontier[tail++] = child;
+					}
+				}
+			}
+			level++;
+		}
+
+		repairSeeds.clear();	// cleared cells take the best distance of a neighbour that kept one, then relax each other in order
+		for (size_t i = 1; i < tail; i++)
+		{
+			uint32_t current = frontier[i];
+			T best = T(-1);
+			for (int j = OpenNeighbours<PACKED, BORDER>(current, neighbours); j--;)
+				if (distances[neighbours[j]] != T(-1))
+					best = std::min(best, T(distances[neighbours[j]] + 1));
+			if (best != T(-1))
+			{
+				distances[current] = best;
+				repairSeeds.push_back(uint64_t(best) << 32 | current);
+			}
+		}
+		std::sort(repairSeeds.begin(), repairSeeds.end());
+
+		// the seeds in order merged with a queue of the cells they lowered, whose distances only grow, so the cells are taken in
+		// distance order without a queue keyed by distance, the seed distances can spread over the whole field
+		size_t seed = 0;
+		head = tail = 0;	// frontier is free again, every cell is lowered at most once so it never outgrows the cleared cells
+		while (seed < repairSeeds.size() || head < tail)
+		{
+			uint32_t current;
+			if (head < tail && (seed == repairSeeds.size() || distances[frontier[head]] <= repairSeeds[seed] >> 32))
+				current = frontier[head++];
+			else
+			{
+				current = uint32_t(repairSeeds[seed]);
+				if (T(repairSeeds[seed++] >> 32) != distances[current])
+					continue;	// lowered by an earlier cell, which queued it
+			}
+			T nextDistance = T(distances[current] + 1);
+			for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i--;)
+				if (distances[neighbours[i]] > nextDistance)
+				{
+					distances[neighbours[i]] = nextDistance;
+					frontier[tail++] = neighbours[i];
+				}
+		}
+	}
+
+	template <bool PACKED, bool BORDER>
+	int OpenNeighbours(uint32_t current, uint32_t neighbours[4]) const	// path cells next to a cell, in the same order as the serial BFS
+	{
+		int x = 0;
+		int y = 0;
+		if (!BORDER)
+		{
+			x = current % stride;	// only needed for the edge checks
+			y = current / stride;
+		}
+
+		int count = 0;
+		if ((BORDER || x < mazeFilledWidth - 1) && IsPath<PACKED>(current + 1))
+			neighbours[count++] = current + 1;
+		if ((BORDER || y > 0) && IsPath<PACKED>(current - stride))
+			neighbours[count++] = current - stride;
+		if ((BORDER || x > 0) && IsPath<PACKED>(current - 1))
+			neighbours[count++] = current - 1;
+		if ((BORDER || y < mazeFilledHeight - 1) && IsPath<PACKED>(current + stride))
+			neighbours[count++] = current + stride;
+		return count;
+	}
+
+	template <bool PACKED, typename T>
+	void FindPath()	// the point to point queries
+	{
+		AllocateFrontier();
+		if (QUERY == TREE && !treeReady)
+			BuildTree();
+		if (QUERY == TREE && isTree)
+		{
+			SENTINEL_BORDER ? FindPathTree<PACKED, true, T>() : FindPathTree<PACKED, false, T>();
+			return;
+		}
+
+		if (QUERY == LANDMARKS && !landmarksReady)
+			SENTINEL_BORDER ? BuildLandmarks<PACKED, true>() : BuildLandmarks<PACKED, false>();
+
+		if (QUERY == LANDMARKS && landmarkCount)
+			SENTINEL_BORDER ? FindPathAStar<PACKED, true, T, true>() : FindPathAStar<PACKED, false, T, true>();
+		else if (QUERY == ASTAR || QUERY == LANDMARKS)
+			SENTINEL_BORDER ? FindPathAStar<PACKED, true, T>() : FindPathAStar<PACKED, false, T>();
+		else if (QUERY == JUMP_POINT)
+			FindPathJumpPoint<PACKED, T>();
+		else
+			SENTINEL_BORDER ? FindPathBidirectional<PACKED, true, T>() : FindPathBidirectional<PACKED, false, T>();
+	}
+
+	template <typename T>
+	void ResetQueriedDistances()	// make every distance unreached again, touching only the cells of the last point to point query when possible
+	{
+		T* distances = DistanceArray<T>();
+		if (queriedFront == SIZE_MAX)
+			memset(distances, -1, sizeof(T) * storedCells);	// set all distances to -1
+		else
+		{
+			for (size_t i = 0; i < queriedFront; i++)
+				distances[frontier[i]] = T(-1);
+			for (size_t i = storedCells - queriedBack; i < storedCells; i++)
+				distances[frontier[i]] = T(-1);
+		}
+	}
+
+	template <bool LANDMARK = false>
+	size_t Heuristic(uint32_t cell) const	// ASTAR and JUMP_POINT, Manhattan distance to the player, never more than the real distance
+	{
+		vi2d position = Position(cell);
+		size_t bound = size_t(abs(position.x - playerPosition.x)) + size_t(abs(position.y - playerPosition.y));
+		if constexpr (LANDMARK)
+			bound = std::max(bound, LandmarkBound(cell, uint32_t(Index(playerPosition.x, playerPosition.y))));	// the larger of two consistent bounds is consistent
+		return bound;
+	}
+
+	size_t LandmarkBound(uint32_t a, uint32_t b) const	// lower bound on the distance between two cells by the triangle inequality, exact when a landmark lies behind one of them
+	{
+		const uint32_t* fromA = landmarkDistances + size_t(a) * landmarkCount;
+		const uint32_t* fromB = landmarkDistances + size_t(b) * landmarkCount;
+		size_t bound = 0;
+		for (int k = 0; k < landmarkCount; k++)
+			if (fromA[k] != UINT32_MAX && fromB[k] != UINT32_MAX)	// a landmark in another component says nothing
+				bound = std::max(bound, size_t(fromA[k] > fromB[k] ? fromA[k] - fromB[k] : fromB[k] - fromA[k]));
+		return bound;
+	}
+
+	void BuildLandmarks()	// LANDMARKS builds them on its first query, call this to pay the cost up front
+	{
+		if (PACKED_WALLS)
+			SENTINEL_BORDER ? BuildLandmarks<true, true>() : BuildLandmarks<true, false>();
+		else
+			SENTINEL_BORDER ? BuildLandmarks<false, true>() : BuildLandmarks<false, false>();
+	}
+
+	template <bool PACKED, bool BORDER>
+	void BuildLandmarks()	// farthest point selection, each landmark is the reachable cell farthest from every landmark before it
+	{
+		const size_t scratch = 2 * storedCells * sizeof(uint32_t);	// flood and nearest below, paid from the budget too
+		int count = int(std::min<size_t>(size_t(std::max(MAX_LANDMARKS, 0)), LANDMARK_BUDGET > scratch ? (LANDMARK_BUDGET - scratch) / (storedCells * sizeof(uint32_t)) : 0));
+		if (count != landmarkCount)
+		{
+			delete[] landmarkDistances;
+			landmarkDistances = count ? new uint32_t[storedCells * count] : nullptr;
+			landmarkCount = count;
+		}
+		landmarksReady = true;
+		AllocateFrontier();
+		ReuseFrontier();
+		if (!count)
+			return;
+
+		std::vector<uint32_t> flood(storedCells);	// one landmark's distances, flooded densely and then copied into its slot in one pass
+		std::vector<uint32_t> nearest(storedCells, UINT32_MAX);	// distance from each cell to the closest landmark so far
+		uint32_t landmark = FloodLandmark<PACKED, BORDER>(uint32_t(Index(goalPosition.x, goalPosition.y)), flood.data());	// the far end of the goal's component makes a better first landmark than the goal
+		for (int k = 0; k < count; k++)
+		{
+			FloodLandmark<PACKED, BORDER>(landmark, flood.data());
+			uint32_t farthest = 0;
+			for (size_t cell = 0; cell < storedCells; cell++)
+			{
+				landmarkDistances[cell * count + k] = flood[cell];
+				nearest[cell] = std::min(nearest[cell], flood[cell]);
+				if (nearest[cell] != UINT32_MAX && nearest[cell] > farthest)
+				{
+					farthest = nearest[cell];
+					landmark = uint32_t(cell);
+				}
+			}
+		}
+	}
+
+	template <bool PACKED, bool BORDER>
+	uint32_t FloodLandmark(uint32_t source, uint32_t* flood)	// BFS from source into flood, UINT32_MAX for unreached cells, returns the last cell reached
+	{
+		memset(flood, -1, sizeof(uint32_t) * storedCells);
+		flood[source] = 0;
+
+		size_t head = 0;
+		size_t tail = 0;
+		frontier[tail++] = source;
+		while (head < tail)
+			ExpandSerial<PACKED, BORDER>(frontier[head++], flood, tail);
+		return frontier[tail - 1];
+	}
+
+	void ReuseFrontier()	// about to overwrite frontier with something other than a query or a flood
+	{
+		queriedFront = SIZE_MAX;	// the last query's cells are no longer listed there
+		if (fieldHead != fieldTail)
+			fieldRoot = SIZE_MAX;	// nor is the queue of an INCREMENTAL_SOLVE flood that stopped early
+	}
+
+	void BuildTree()	// TREE builds it on its first query, call this to pay the cost up front
+	{
+		if (PACKED_WALLS)
+			SENTINEL_BORDER ? BuildTree<true, true>() : BuildTree<true, false>();
+		else
+			SENTINEL_BORDER ? BuildTree<false, true>() : BuildTree<false, false>();
+	}
+
+	template <bool PACKED, bool BORDER>
+	void BuildTree()	// Euler tour of a depth first walk from the first path cell, then a sparse table of the shallowest entry over blocks of the tour
+	{
+		if (!treeDepth)
+		{
+			treeDepth = new uint32_t[storedCells];
+			treeFirst = new uint32_t[storedCells];
+		}
+		treeReady = true;
+		AllocateFrontier();
+		ReuseFrontier();
+		memset(treeDepth, -1, sizeof(uint32_t) * storedCells);
+
+		size_t pathCells = 0;	// a connected graph is a tree when it has one edge less than it has cells
+		size_t edges = 0;
+		uint32_t root = 0;
+		uint32_t neighbours[4];
+		for (int y = 0; y < mazeFilledHeight; y++)
+			for (int x = 0; x < mazeFilledWidth; x++)
+			{
+				uint32_t cell = uint32_t(Index(x, y));
+				if (!IsPath<PACKED>(cell))
+					continue;
+				if (!pathCells++)
+					root = cell;
+				edges += (x < mazeFilledWidth - 1 && IsPath<PACKED>(cell + 1)) + (y < mazeFilledHeight - 1 && IsPath<PACKED>(cell + stride));
+			}
+		isTree = pathCells && edges == pathCells - 1;
+		if (!isTree)
+			return;
+
+		eulerTour.clear();
+		tourDepth.clear();
+		eulerTour.reserve(2 * pathCells - 1);	// every edge is walked down and back up
+		tourDepth.reserve(2 * pathCells - 1);
+		size_t top = 0;			// frontier is the walk's stack
+		frontier[top++] = root;
+		treeDepth[root] = 0;
+		treeFirst[root] = 0;
+		eulerTour.push_back(root);
+		tourDepth.push_back(0);
+		size_t reached = 1;
+		while (top)
+		{
+			uint32_t current = frontier[top - 1];
+			uint32_t child = UINT32_MAX;
+			for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i-- && child == UINT32_MAX;)
+				if (treeDepth[neighbours[i]] == UINT32_MAX)
+					child = neighbours[i];
+
+			if (child != UINT32_MAX)
+			{
+				treeDepth[child] = treeDepth[current] + 1;
+				treeFirst[child] = uint32_t(eulerTour.size());
+				frontier[top++] = child;
+				reached++;
+			}
+			else if (--top)
+				child = frontier[top - 1];	// back up to the parent
+			else
+				break;
+			eulerTour.push_back(child);
+			tourDepth.push_back(treeDepth[child]);
+		}
+		isTree = reached == pathCells;	// the edge count alone also fits a forest with a loop in one of its trees
+		if (!isTree)
+			return;
+
+		const size_t blocks = (eulerTour.size() + TREE_BLOCK - 1) / TREE_BLOCK;
+		size_t levels = 1;
+		while ((size_t(1) << levels) <= blocks)
+			levels++;
+		blockMinimum.resize(levels * blocks);
+		for (size_t b = 0; b < blocks; b++)
+			blockMinimum[b] = ShallowestEntry(b * TREE_BLOCK, std::min(eulerTour.size(), (b + 1) * TREE_BLOCK) - 1);
+		for (size_t j = 1; j < levels; j++)
+			for (size_t b = 0; b + (size_t(1) << j) <= blocks; b++)
+			{
+				uint32_t left = blockMinimum[(j - 1) * blocks + b];
+				uint32_t right = blockMinimum[(j - 1) * blocks + b + (size_t(1) << (j - 1))];
+				blockMinimum[j * blocks + b] = tourDepth[right] < tourDepth[left] ? right : left;
+			}
+	}
+
+	uint32_t ShallowestEntry(size_t from, size_t to) const	// TREE, tour position of the shallowest entry in [from, to] by scanning
+	{
+		size_t best = from;
+		for (size_t i = from + 1; i <= to; i++)
+			if (tourDepth[i] < tourDepth[best])
+				best = i;
+		return uint32_t(best);
+	}
+
+	uint32_t CommonAncestor(uint32_t a, uint32_t b) const	// TREE, the shallowest tour entry between the first visits of two cells, at most two block scans and one table lookup
+	{
+		size_t from = treeFirst[a];
+		size_t to = treeFirst[b];
+		if (from > to)
+			std::swap(from, to);
+		size_t firstBlock = from / TREE_BLOCK + 1;	// whole blocks strictly inside the range
+		size_t lastBlock = to / TREE_BLOCK;
+		if (firstBlock >= lastBlock)
+			return eulerTour[ShallowestEntry(from, to)];
+
+		size_t best = ShallowestEntry(from, firstBlock * TREE_BLOCK - 1);
+		size_t tail = ShallowestEntry(lastBlock * TREE_BLOCK, to);
+		if (tourDepth[tail] < tourDepth[best])
+			best = tail;
+		const size_t blocks = (eulerTour.size() + TREE_BLOCK - 1) / TREE_BLOCK;
+		size_t level = 0;
+		while ((size_t(2) << level) <= lastBlock - firstBlock)
+			level++;
+		for (size_t b : { firstBlock, lastBlock - (size_t(1) << level) })
+			if (tourDepth[blockMinimum[level * blocks + b]] < tourDepth[best])
+				best = blockMinimum[level * blocks + b];
+		return eulerTour[best];
+	}
+
+	uint32_t TreeDistance(vi2d a, vi2d b)	// TREE, distance between two path cells of a maze without loops, UINT32_MAX when it has loops or either is a wall
+	{
+		if (!treeReady)
+			BuildTree();
+		uint32_t cellA = uint32_t(Index(a.x, a.y));
+		uint32_t cellB = uint32_t(Index(b.x, b.y));
+		if (!isTree || treeDepth[cellA] == UINT32_MAX || treeDepth[cellB] == UINT32_MAX)
+			return UINT32_MAX;
+		return treeDepth[cellA] + treeDepth[cellB] - 2 * treeDepth[CommonAncestor(cellA, cellB)];
+	}
+
+	template <bool PACKED, bool BORDER>
+	uint32_t TreeParent(uint32_t cell) const	// TREE, the one neighbour closer to the root
+	{
+		uint32_t neighbours[4];
+		for (int i = OpenNeighbours<PACKED, BORDER>(cell, neighbours); i--;)
+			if (treeDepth[neighbours[i]] + 1 == treeDepth[cell])
+				return neighbours[i];
+		return cell;
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void FindPathTree()	// TREE, climbs from the player and the goal to their common ancestor, O(path length) and no distances written
+	{
+		ResetQueriedDistances<T>();	// leave no stale field for DrawMaze to colour, every cell reads as unreached like outside a POINT_TO_POINT query
+		queriedFront = queriedBack = 0;	// so the next TREE query has nothing to reset
+		const uint32_t goal = uint32_t(Index(goalPosition.x, goalPosition.y));
+		const uint32_t player = uint32_t(Index(playerPosition.x, playerPosition.y));
+		const uint32_t ancestor = CommonAncestor(goal, player);
+		const uint32_t goalSteps = treeDepth[goal] - treeDepth[ancestor];
+		const uint32_t playerSteps = treeDepth[player] - treeDepth[ancestor];
+		largestDistance = goalSteps + playerSteps;
+		shortestPath.resize(largestDistance);	// same order as TracePath, shortestPath[i] is the cell i steps from the goal
+		expandedCells = 0;
+
+		uint32_t current = goal;
+		for (uint32_t i = 0; i < goalSteps; i++)
+		{
+			shortestPath[i] = Position(current);
+			current = TreeParent<PACKED, BORDER>(current);
+		}
+		current = player;
+		for (uint32_t j = 1; j <= playerSteps; j++)
+		{
+			current = TreeParent<PACKED, BORDER>(current);
+			shortestPath[largestDistance - j] = Position(current);
+		}
+	}
+
+	template <bool PACKED, bool BORDER, typename T, bool LANDMARK = false>
+	void FindPathAStar()	// ASTAR and LANDMARKS, searches from the goal so TracePath can walk the distances back from the player like after a flood
+	{
+		T* distances = DistanceArray<T>();
+		ResetQueriedDistances<T>();
+
+		const uint32_t goal = uint32_t(Index(goalPosition.x, goalPosition.y));
+		const uint32_t player = uint32_t(Index(playerPosition.x, playerPosition.y));
+		size_t touched = 0;		// frontier lists every cell given a distance, so the next query can undo them
+		openCells.Clear();
+		distances[goal] = 0;
+		frontier[touched++] = goal;
+		openCells.Push(goal, Heuristic<LANDMARK>(goal));
+		expandedCells = 0;
+
+		uint32_t current;
+		size_t key;
+		uint32_t neighbours[4];
+		while (openCells.Pop(current, key))
+		{
+			if (key != distances[current] + Heuristic<LANDMARK>(current))
+				continue;		// a shorter way to this cell was queued after this entry
+			expandedCells++;
+			if (current == player)
+				break;
+
+			T nextDistance = distances[current] + 1;
+			for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i--;)
+			{
+				uint32_t next = neighbours[i];
+				if (distances[next] == T(-1))
+					frontier[touched++] = next;
+				else if (distances[next] <= nextDistance)
+					continue;
+				distances[next] = nextDistance;
+				openCells.Push(next, nextDistance + Heuristic<LANDMARK>(next));
+			}
+		}
+
+		queriedFront = touched;
+		queriedBack = 0;
+		FinishQuery<T>();
+	}
+
+	void FinishQuery()
+	{
+		if (narrowDistances)
+			FinishQuery<uint16_t>();
+		else
+			FinishQuery<uint32_t>();
+	}
+
+	template <typename T>
+	void FinishQuery()	// every stored distance is a real path length and the player's is the shortest, so TracePath works as is unless SetCell cut the player off
+	{
+		if (DistanceArray<T>()[Index(playerPosition.x, playerPosition.y)] == T(-1))
+		{
+			largestDistance = 0;	// the player cannot reach the goal
+			shortestPath.clear();
+		}
+		else
+			TracePath<T>();
+	}
+
+	template <bool PACKED>
+	bool OpenAt(int x, int y) const	// JUMP_POINT, path cell test that also accepts positions past the border, so it needs no BORDER variant
+	{
+		return x >= -border && x < mazeFilledWidth + border && y >= -border && y < mazeFilledHeight + border && IsPath<PACKED>(Index(x, y));
+	}
+
+	template <bool PACKED>
+	unsigned int ForcedSides(vi2d cell, int direction, size_t steps) const	// JUMP_POINT, sides of a cell reached by a vertical move that no equally short path reaches
+	{
+		const int dy = directions[direction].y;
+		unsigned int forced = 0;
+		for (int side = 1; side <= 3; side += 2)	// directions[1] and directions[3], left and right
+		{
+			const int dx = directions[side].x;
+			if (!OpenAt<PACKED>(cell.x + dx, cell.y))
+				continue;
+			if (OpenAt<PACKED>(cell.x + dx, cell.y - dy))
+				continue;	// the cell before this one reaches the side as fast, plain 4-connected jump point search
+
+			// the same one row further back: the maze walls every (odd, odd) cell, so the check above fails beside every node even
+			// though the side corridor leads to a node that the node two cells back reaches just as fast through its own side
+			bool around = steps >= 2 && vi2d{ cell.x + dx, cell.y } != playerPosition && !OpenAt<PACKED>(cell.x + dx, cell.y + dy)
+				&& OpenAt<PACKED>(cell.x + dx, cell.y - 2 * dy) && OpenAt<PACKED>(cell.x + 2 * dx, cell.y - 2 * dy)
+				&& OpenAt<PACKED>(cell.x + 2 * dx, cell.y - dy) && OpenAt<PACKED>(cell.x + 2 * dx, cell.y);
+			if (!around)
+				forced |= 1u << side;
+		}
+		return forced;
+	}
+
+	template <bool PACKED>
+	uint32_t Jump(vi2d cell, int direction, size_t& steps) const	// JUMP_POINT, first cell in a straight line worth expanding, UINT32_MAX if the line ends first
+	{
+		const bool vertical = !(direction & 1);
+		steps = 0;
+		for (;;)
+		{
+			cell = cell + directions[direction];
+			if (!OpenAt<PACKED>(cell.x, cell.y))
+				return UINT32_MAX;
+			steps++;
+			if (cell == playerPosition)
+				break;
+			size_t probe;
+			if (vertical ? ForcedSides<PACKED>(cell, direction, steps) != 0
+				: Jump<PACKED>(cell, 0, probe) != UINT32_MAX || Jump<PACKED>(cell, 2, probe) != UINT32_MAX)
+				break;		// a horizontal run stops where either vertical run from it finds something
+		}
+		return uint32_t(Index(cell.x, cell.y));
+	}
+
+	template <bool PACKED, typename T>
+	void FindPathJumpPoint()	// JUMP_POINT, horizontal runs branch up and down everywhere, vertical runs only where ForcedSides says so
+	{
+		T* distances = DistanceArray<T>();
+		ResetQueriedDistances<T>();
+
+		const int offsets[4] = { stride, -1, -stride, 1 };	// directions[] as linear offsets
+		const uint32_t goal = uint32_t(Index(goalPosition.x, goalPosition.y));
+		const uint32_t player = uint32_t(Index(playerPosition.x, playerPosition.y));
+		size_t touched = 0;
+		openJumps.Clear();
+		distances[goal] = 0;
+		frontier[touched++] = goal;
+		openJumps.Push(goal | uint64_t(4) << 32, Heuristic(goal));	// 4, reached by no move, every direction is open
+		expandedCells = 0;
+
+		uint64_t entry;
+		size_t key;
+		while (openJumps.Pop(entry, key))
+		{
+			uint32_t current = uint32_t(entry);
+			int arrival = int(entry >> 32);
+			if (key != distances[current] + Heuristic(current))
+				continue;		// a shorter way to this cell was queued after this entry
+			expandedCells++;
+			if (current == player)
+				break;
+
+			vi2d position = Position(current);
+			unsigned int moves = 0xF;
+			if (arrival < 4)	// keep going the same way, plus up and down after a horizontal move or the forced sides after a vertical one
+				moves = 1u << arrival | (arrival & 1 ? 0x5 : ForcedSides<PACKED>(position, arrival, 1));
+
+			for (int direction = 0; direction < 4; direction++)
+			{
+				size_t steps;
+				uint32_t next;
+				if (!(moves >> direction & 1) || (next = Jump<PACKED>(position, direction, steps)) == UINT32_MAX)
+					continue;
+				T nextDistance = T(distances[current] + steps);
+				if (distances[next] != T(-1) && distances[next] <= nextDistance)
+					continue;
+
+				uint32_t cell = current;	// give the run its distances too, TracePath steps through every cell
+				for (size_t step = 1; step <= steps; step++)
+				{
+					cell += offsets[direction];
+					if (distances[cell] == T(-1))
+						frontier[touched++] = cell;
+					if (T(distances[current] + step) < distances[cell])
+						distances[cell] = T(distances[current] + step);
+				}
+				openJumps.Push(next | uint64_t(direction) << 32, nextDistance + Heuristic(next));
+			}
+		}
+
+		queriedFront = touched;
+		queriedBack = 0;
+		FinishQuery<T>();
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void FindPathBidirectional()	// POINT_TO_POINT, level by level from whichever side has the smaller level, until a level touches the other side
+	{
+		T* distances = DistanceArray<T>();
+		const T unreached = T(-1);
+		const T top = T(unreached - 1);	// player side distances count down from here and goal side ones up from 0, they never get close enough to mix
+		ResetQueriedDistances<T>();
+
+		const uint32_t goal = uint32_t(Index(goalPosition.x, goalPosition.y));
+		const uint32_t player = uint32_t(Index(playerPosition.x, playerPosition.y));
+		size_t goalHead = 0;					// goal side queue grows up from the start of frontier
+		size_t goalTail = 0;
+		size_t playerHead = storedCells;		// player side queue grows down from the end, a cell is only ever in one of them
+		size_t playerTail = storedCells;
+		distances[goal] = 0;
+		frontier[goalTail++] = goal;
+		if (player != goal)
+		{
+			distances[player] = top;
+			frontier[--playerTail] = player;
+		}
+
+		T goalDepth = 0;		// distance of the newest goal side level
+		T playerDepth = 0;		// distance of the newest player side level
+		size_t best = SIZE_MAX;	// shortest length through a pair of touching cells seen so far
+		uint32_t meetGoal = goal;
+		uint32_t meetPlayer = player;
+		uint32_t neighbours[4];
+		while (best == SIZE_MAX && player != goal && goalHead < goalTail && playerTail < playerHead)
+		{
+			if (goalTail - goalHead <= playerHead - playerTail)
+			{
+				T nextDistance = goalDepth + 1;
+				for (size_t levelEnd = goalTail; goalHead < levelEnd; goalHead++)
+				{
+					uint32_t current = frontier[goalHead];
+					for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i--;)
+					{
+						T distance = distances[neighbours[i]];
+						if (distance == unreached)
+						{
+							distances[neighbours[i]] = nextDistance;
+							frontier[goalTail++] = neighbours[i];
+						}
+						else if (distance >= top - playerDepth && size_t(nextDistance) + (top - distance) < best)
+						{
+							best = size_t(nextDistance) + (top - distance);
+							meetGoal = current;
+							meetPlayer = neighbours[i];
+						}
+					}
+				}
+				goalDepth = nextDistance;
+			}
+			else
+			{
+				T nextDistance = top - playerDepth - 1;
+				for (size_t levelEnd = playerTail; playerHead > levelEnd;)
+				{
+					uint32_t current = frontier[--playerHead];
+					for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i--;)
+					{
+						T distance = distances[neighbours[i]];
+						if (distance == unreached)
+						{
+							distances[neighbours[i]] = nextDistance;
+							frontier[--playerTail] = neighbours[i];
+						}
+						else if (distance <= goalDepth && size_t(distance) + 1 + playerDepth < best)
+						{
+							best = size_t(distance) + 1 + playerDepth;
+							meetGoal = neighbours[i];
+							meetPlayer = current;
+						}
+					}
+				}
+				playerDepth++;
+			}
+		}
+
+		largestDistance = best == SIZE_MAX ? 0 : uint32_t(best);	// 0 when the player is on the goal or cannot reach it
+		shortestPath.resize(largestDistance);
+		if (best != SIZE_MAX)
+		{
+			for (uint32_t current = meetGoal;;)	// goal half, shortestPath[i] is the cell i steps from the goal
+			{
+				T distance = distances[current];
+				shortestPath[distance] = Position(current);
+				if (!distance)
+					break;
+				for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i--;)
+				{
+					if (distances[neighbours[i]] == T(distance - 1))
+					{
+						current = neighbours[i];
+						break;
+					}
+				}
+			}
+			for (uint32_t current = meetPlayer; current != player;)	// player half, stepping towards the player
+			{
+				T distance = distances[current];
+				shortestPath[best - (top - distance)] = Position(current);
+				for (int i = OpenNeighbours<PACKED, BORDER>(current, neighbours); i--;)
+				{
+					if (distances[neighbours[i]] == T(distance + 1))
+					{
+						current = neighbours[i];
+						break;
+					}
+				}
+			}
+		}
+
+		// player side cells hold distances from the player, keep only the path so every stored distance is from the goal like after a flood
+		for (size_t i = playerTail; i < storedCells; i++)
+			distances[frontier[i]] = unreached;
+		if (best != SIZE_MAX)
+		{
+			for (size_t i = distances[meetGoal] + 1; i < best; i++)
+				distances[Index(shortestPath[i].x, shortestPath[i].y)] = T(i);
+			distances[player] = T(best);
+		}
+		queriedFront = goalTail;
+		queriedBack = storedCells - playerTail;
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void ExpandCell(uint32_t current, T* distances, std::vector<uint32_t>& found)	// multithreaded BFS, claims the unreached open neighbours of a cell
+	{
+		T nextDistance = distances[current] + 1;
+		int x = 0;
+		int y = 0;
+		if (!BORDER)
+		{
+			x = current % stride;	// only needed for the edge checks
+			y = current / stride;
+		}
+
+		const bool inside[4] = { BORDER || x < mazeFilledWidth - 1, BORDER || y > 0, BORDER || x > 0, BORDER || y < mazeFilledHeight - 1 };
+		const uint32_t neighbours[4] = { current + 1, current - stride, current - 1, current + stride };	// same order as the serial BFS
+		for (int i = 0; i < 4; i++)
+		{
+			if (!inside[i] || !IsPath<PACKED>(neighbours[i]))
+				continue;
+			std::atomic_ref<T> distance(distances[neighbours[i]]);
+			T unreached = T(-1);
+			if (distance.load(std::memory_order_relaxed) == unreached && distance.compare_exchange_strong(unreached, nextDistance, std::memory_order_relaxed))
+				found.push_back(neighbours[i]);	// only the thread that wins the exchange queues the cell
+		}
+	}
+
+	template <bool PACKED, bool BORDER, typename T>
+	void FloodDistancesParallel(int threads)	// level synchronous BFS, every level gives the same distances as the serial BFS whatever thread reaches a cell first
+	{
+		T* distances = DistanceArray<T>();
+		memset(distances, -1, sizeof(T) * storedCells);	// set all distances to -1
+
+		size_t head = 0;	// first cell of the current level
+		size_t tail = 0;	// next free slot in the frontier
+		distances[Index(goalPosition.x, goalPosition.y)] = 0;	// set the goal distance to 0
+		frontier[tail++] = uint32_t(Index(goalPosition.x, goalPosition.y));	// add the goal to the queue
+
+		const std::function<void(int)> expandLevel = [&](int thread)	// each thread takes an equal slice of the current level
+		{
+			size_t levelSize = tail - head;
+			size_t first = head + levelSize * thread / threads;
+			size_t last = head + levelSize * (thread + 1) / threads;
+			for (size_t i = first; i < last; i++)
+				ExpandCell<PACKED, BORDER, T>(frontier[i], distances, threadFrontiers[thread]);
+		};
+
+		while (head < tail)
+		{
+			size_t levelEnd = tail;
+			if (levelEnd - head < PARALLEL_LEVEL_SIZE)	// small level, the plain serial loop straight into frontier, no atomics and no other thread
+			{
+				for (; head < levelEnd; head++)
+					ExpandSerial<PACKED, BORDER>(frontier[head], distances, tail);
+				continue;
+			}
+
+			if (solverPool.Size() != threads)	// first shared level, or SOLVER_THREADS changed
+			{
+				solverPool.Resize(threads);
+				threadFrontiers.resize(threads);
+			}
+			solverPool.Run(expandLevel);
+
+			head = levelEnd;
+			for (auto& found : threadFrontiers)	// append every thread's cells as the next level
+			{
+				std::copy(found.begin(), found.end(), frontier + tail);	// memcpy would be handed a null pointer for an empty vector
+				tail += found.size();
+				found.clear();
+			}
+		}
+	}
+
+	template <typename T>
+	void FloodDistancesBitParallel()	// level synchronous BFS, next = (frontier shifted up, down, left and right) & PATH & ~visited
+	{
+		const size_t words = storedCells / 64;
+		const size_t wordsPerRow = stride / 64;
+		if (!visitedBits)
+		{
+			frontierBits = new uint64_t[words];
+			nextBits = new uint64_t[words];
+			visitedBits = new uint64_t[words];
+			memset(frontierBits, 0, sizeof(uint64_t) * words);	// kept clear between solves, only the active words are ever dirty
+			memset(nextBits, 0, sizeof(uint64_t) * words);
+		}
+		memset(visitedBits, 0, sizeof(uint64_t) * words);
+
+		T* distances = DistanceArray<T>();
+		memset(distances, -1, sizeof(T) * storedCells);	// set all distances to -1
+
+		size_t goal = Index(goalPosition.x, goalPosition.y);
+		distances[goal] = 0;
+		frontierBits[goal >> 6] = visitedBits[goal >> 6] = uint64_t(1) << (goal & 63);
+
+		activeWords.clear();
+		activeWords.push_back(uint32_t(goal >> 6));
+		for (uint32_t level = 1; !activeWords.empty(); level++)
+		{
+			nextWords.clear();	// words holding the next level, listed when they first receive a cell
+			for (uint32_t w : activeWords)	// push the whole word of frontier cells one step in every direction at once
+			{
+				uint64_t cells = frontierBits[w];
+				frontierBits[w] = 0;	// the level is done with this word
+				Spread(w, cells << 1 | cells >> 1, T(level), distances);							// left and right inside the word
+				if (cells >> 63 && w + 1 < words) Spread(w + 1, uint64_t(1), T(level), distances);	// carry across words, the wall column at the end of each row stops it crossing rows
+				if (cells & 1 && w > 0) Spread(w - 1, uint64_t(1) << 63, T(level), distances);
+				if (w >= wordsPerRow) Spread(w - wordsPerRow, cells, T(level), distances);			// up and down
+				if (w + wordsPerRow < words) Spread(w + wordsPerRow, cells, T(level), distances);
+			}
+			std::swap(frontierBits, nextBits);	// nextBits is all clear again, the loop above emptied every word it had
+			std::swap(activeWords, nextWords);
+		}
+	}
+
+	template <typename T>
+	void Spread(uint32_t word, uint64_t cells, T level, T* distances)	// BIT_PARALLEL_BFS, claims the unvisited path cells among cells for the next level
+	{
+		uint64_t reached = cells & mazeBits[word] & ~visitedBits[word];
+		if (!reached)
+			return;
+		visitedBits[word] |= reached;	// cells of one level may reach each other's words, visited stops them being claimed twice
+		if (!nextBits[word])
+			nextWords.push_back(word);
+		nextBits[word] |= reached;
+		for (; reached; reached &= reached - 1)	// write the level into every new cell of the word
+			distances[size_t(word) * 64 + std::countr_zero(reached)] = level;
+	}
+
+	void TracePath()	// follow decreasing distances from the player to the goal
+	{
+		if (narrowDistances)
+			TracePath<uint16_t>();
+		else
+			TracePath<uint32_t>();
+	}
+
+	template <typename T>
+	void TracePath()
+	{
+		T* distances = DistanceArray<T>();
+		largestDistance = distances[Index(playerPosition.x, playerPosition.y)];	// set the largest distance to the distance to the player
+		shortestPath.resize(largestDistance);	// resize the shortest path vector to the largest distance
+
+		vi2d current = playerPosition;			// start at the player position
+		vi2d nextPos;
+		for (int i = largestDistance; i--;)
+		{
+			size_t currentIndex = Index(current.x, current.y);
+			for (int j = 4; j--;)
+			{
+				nextPos = current + directions[j];
+				if ((SENTINEL_BORDER || (nextPos.x >= 0 && nextPos.x < mazeFilledWidth && nextPos.y >= 0 && nextPos.y < mazeFilledHeight)) && distances[Index(nextPos.x, nextPos.y)] == T(distances[currentIndex] - 1))
+					break;				// move to the next position with the lowest distance
+			}
+			shortestPath[i] = nextPos;	// add the next position to the shortest path
+			current = nextPos;			// set the current position to the next position
+		}
+	}
+
+	bool MovePlayer()	// returns true if the player stepped along the path, false if it reached the goal and a new one was picked
+	{
+		if (shortestPath.size() >= 2)
+		{
+			shortestPath.pop_back();				// remove the last position from the shortest path
+			playerPosition = shortestPath.back();	// set the player position to the last position in the shortest path
+			return true;
+		}
+
+		RandomizeGoal();	// randomize the goal
+		FindShortestPath();	// find the new shortest path
+		return false;
+	}
+
+	void NewScene()
+	{
+		RandomizeMaze();	// randomize the maze
+		RandomizePlayer();	// randomize the player position
+		RandomizeGoal();	// randomize the goal position
+		FindShortestPath();	// find the shortest path to the goal
+	}
+};
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <cmath>
+#include <algorithm>
+
+#include "MazeCore.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MAZE_FADE_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MAZE_FADE_TARGET(isa)			// MSVC compiles any intrinsic anywhere, the caller checks the CPU first
+#else
+#define MAZE_FADE_TARGET(isa) __attribute__((target(isa)))	// GCC and Clang only emit instructions a function is marked for
+#endif
+#endif
+
+// DrawMaze's colour fade, one row of cells per call:
+//	target = distance * 255 / (largestDistance + 1)
+//	color = color + (target - color) * fade, snapped to target once it is closer than SNAP, at most 255
+//	pixel = magenta with color in green
+// fade covers any number of simulation steps at once, 1 - (1 - rate)^steps, as long as the distances did not change in between.
+// the snap makes the fade end after a finite number of steps, a row reports whether any color still moved so the caller can
+// stop redrawing it. only path cells are written, walls keep whatever the frame was cleared to. Every kernel does the same
+// float operations in the same order, so they give the same pixels and the kernel can be picked per host at run time.
+class MazeFade
+{
+public:
+	enum Kernel
+	{
+		SCALAR,	// one cell at a time, every host
+		SSE41,	// 4 cells per instruction, needs SSE4.1 for the unsigned min and the blends
+		AVX2	// 8 cells per instruction
+	};
+
+	static Kernel Detect()	// the widest kernel this CPU and OS run
+	{
+#if defined(MAZE_FADE_X86)
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int highest = info[0];
+		__cpuid(info, 1);
+		const bool sse41 = info[2] & (1 << 19);
+		const bool osxsave = info[2] & (1 << 27);	// the OS saves the ymm registers, checked with xgetbv
+		bool avx2 = false;
+		if (highest >= 7 && osxsave && (_xgetbv(0) & 6) == 6)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = info[1] & (1 << 5);
+		}
+#else
+		__builtin_cpu_init();
+		const bool sse41 = __builtin_cpu_supports("sse4.1");
+		const bool avx2 = __builtin_cpu_supports("avx2");	// also checks the OS support
+#endif
+		if (avx2)
+			return AVX2;
+		if (sse41)
+			return SSE41;
+#endif
+		return SCALAR;
+	}
+
+	template <bool PACKED, typename T>
+	static bool Row(Kernel kernel, const MazeCore& maze, const T* distances, size_t row, int count, float scale, float fade, float* colors, uint32_t* pixels)	// cells row to row + count - 1, colors and pixels start at the row's first cell, false when no color changed
+	{
+#if defined(MAZE_FADE_X86)
+		if (kernel == AVX2)
+			return RowAVX2<PACKED, T>(maze, distances, row, count, scale, fade, colors, pixels);
+		if (kernel == SSE41)
+			return RowSSE41<PACKED, T>(maze, distances, row, count, scale, fade, colors, pixels);
+#endif
+		return RowScalar<PACKED, T>(maze, distances, row, 0, count, scale, fade, colors, pixels);
+	}
+
+	template <bool PACKED, typename T>
+	static bool RowScalar(const MazeCore& maze, const T* distances, size_t row, int first, int count, float scale, float fade, float* colors, uint32_t* pixels)	// also the tail of the wider kernels
+	{
+		bool changed = false;
+		for (int x = first; x < count; x++)
+		{
+			if (!maze.IsPath<PACKED>(row + x))
+				continue;
+			float target = float(std::min<uint32_t>(distances[row + x], INT32_MAX)) * scale;	// clamped like the vector kernels, which convert as signed
+			float color = colors[x] + (target - colors[x]) * fade;
+			if (std::abs(target - color) < SNAP)
+				color = target;
+			color = std::min(255.0f, color);
+			changed |= color != colors[x];
+			colors[x] = color;
+			pixels[x] = MAGENTA | uint32_t(color) << 8;
+		}
+		return changed;
+	}
+
+	static const uint32_t MAGENTA = 0xFFFF00FF;	// olc::Pixel(255, 0, 255), green is or-ed in at bit 8
+	static constexpr float SNAP = 0.5f;			// a color this close to its target is set to it, less than a green level away
+
+	static uint32_t PathBits(const MazeCore& maze, size_t index)	// PATH of the 8 cells from index in the low bits, PACKED only
+	{
+		const size_t word = index >> 6;
+		const unsigned shift = index & 63;
+		uint64_t bits = maze.mazeBits[word] >> shift;
+		if (shift > 56)
+			bits |= maze.mazeBits[word + 1] << (64 - shift);	// the cells run into the next word, still inside the row
+		return uint32_t(bits & 0xFF);
+	}
+
+#if defined(MAZE_FADE_X86)
+	template <bool PACKED, typename T>
+	MAZE_FADE_TARGET("sse4.1")
+	static bool RowSSE41(const MazeCore& maze, const T* distances, size_t row, int count, float scale, float fade, float* colors, uint32_t* pixels)
+	{
+		const __m128 k = _mm_set1_ps(scale);
+		const __m128 step = _mm_set1_ps(fade);
+		const __m128 top = _mm_set1_ps(255.0f);
+		const __m128 snap = _mm_set1_ps(SNAP);
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		const __m128i limit = _mm_set1_epi32(INT32_MAX);
+		const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+		const __m128i pathFlag = _mm_set1_epi32(MazeCore::PATH);
+		const __m128i magenta = _mm_set1_epi32(int(MAGENTA));
+
+		int changed = 0;
+		int x = 0;
+		for (; x + 4 <= count; x += 4)
+		{
+			const size_t i = row + x;
+			__m128i open;
+			if constexpr (PACKED)
+				open = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(int(PathBits(maze, i))), lanes), lanes);
+			else
+			{
+				int bytes;
+				memcpy(&bytes, maze.maze + i, sizeof(bytes));
+				open = _mm_cmpeq_epi32(_mm_and_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)), pathFlag), pathFlag);
+			}
+			if (_mm_testz_si128(open, open))
+				continue;	// four walls
+
+			__m128i distance;
+			if constexpr (sizeof(T) == sizeof(uint16_t))
+				distance = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(distances + i)));
+			else
+				distance = _mm_min_epu32(_mm_loadu_si128((const __m128i*)(distances + i)), limit);
+			__m128 target = _mm_mul_ps(_mm_cvtepi32_ps(distance), k);
+			__m128 color = _mm_loadu_ps(colors + x);
+			__m128 next = _mm_add_ps(color, _mm_mul_ps(_mm_sub_ps(target, color), step));
+			next = _mm_blendv_ps(next, target, _mm_cmplt_ps(_mm_andnot_ps(sign, _mm_sub_ps(target, next)), snap));
+			next = _mm_blendv_ps(color, _mm_min_ps(next, top), _mm_castsi128_ps(open));
+			changed |= _mm_movemask_ps(_mm_cmpneq_ps(next, color));
+			_mm_storeu_ps(colors + x, next);
+			__m128i pixel = _mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(next), 8), magenta);
+			_mm_storeu_si128((__m128i*)(pixels + x), _mm_blendv_epi8(_mm_loadu_si128((const __m128i*)(pixels + x)), pixel, open));
+		}
+		return RowScalar<PACKED, T>(maze, distances, row, x, count, scale, fade, colors, pixels) || changed;
+	}
+
+	template <bool PACKED, typename T>
+	MAZE_FADE_TARGET("avx2")
+	static bool RowAVX2(const MazeCore& maze, const T* distances, size_t row, int count, float scale, float fade, float* colors, uint32_t* pixels)
+	{
+		const __m256 k = _mm256_set1_ps(scale);
+		const __m256 step = _mm256_set1_ps(fade);
+		const __m256 top = _mm256_set1_ps(255.0f);
+		const __m256 snap = _mm256_set1_ps(SNAP);
+		const __m256 sign = _mm256_set1_ps(-0.0f);
+		const __m256i limit = _mm256_set1_epi32(INT32_MAX);
+		const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+		const __m256i pathFlag = _mm256_set1_epi32(MazeCore::PATH);
+		const __m256i magenta = _mm256_set1_epi32(int(MAGENTA));
+
+		int changed = 0;
+		int x = 0;
+		for (; x + 8 <= count; x += 8)
+		{
+			const size_t i = row + x;
+			__m256i open;
+			if constexpr (PACKED)
+				open = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(int(PathBits(maze, i))), lanes), lanes);
+			else
+				open = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(maze.maze + i))), pathFlag), pathFlag);
+			if (_mm256_testz_si256(open, open))
+				continue;	// eight walls
+
+			__m256i distance;
+			if constexpr (sizeof(T) == sizeof(uint16_t))
+				distance = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(distances + i)));
+			else
+				distance = _mm256_min_epu32(_mm256_loadu_si256((const __m256i*)(distances + i)), limit);
+			__m256 target = _mm256_mul_ps(_mm256_cvtepi32_ps(distance), k);
+			__m256 color = _mm256_loadu_ps(colors + x);
+			__m256 next = _mm256_add_ps(color, _mm256_mul_ps(_mm256_sub_ps(target, color), step));
+			next = _mm256_blendv_ps(next, target, _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(target, next)), snap, _CMP_LT_OQ));
+			next = _mm256_blendv_ps(color, _mm256_min_ps(next, top), _mm256_castsi256_ps(open));
+			changed |= _mm256_movemask_ps(_mm256_cmp_ps(next, color, _CMP_NEQ_UQ));
+			_mm256_storeu_ps(colors + x, next);
+			__m256i pixel = _mm256_or_si256(_mm256_slli_epi32(_mm256_cvttps_epi32(next), 8), magenta);
+			_mm256_storeu_si256((__m256i*)(pixels + x), _mm256_blendv_epi8(_mm256_loadu_si256((const __m256i*)(pixels + x)), pixel, open));
+		}
+		return RowScalar<PACKED, T>(maze, distances, row, x, count, scale, fade, colors, pixels) || changed;
+	}
+#endif
+};
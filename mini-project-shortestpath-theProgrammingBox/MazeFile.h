@@ -0,0 +1,248 @@
+#pragma once
+
+#include <fstream>
+#include <vector>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "MazeCore.h"
+
+// Binary maze file, little endian:
+//	Header										64 bytes
+//	PATH grid, exactly MazeCore::mazeBits		storedCells / 8 bytes, packed layout with or without the sentinel border
+//	distance field, optional					storedCells * 2 or 4 bytes at distancesOffset, 0xFFFF... for unreached cells
+// Open maps the file copy on write and Attach points a MazeCore at it, so loading costs page faults instead of a regeneration
+// and later edits to the maze never reach the file.
+class MazeFile
+{
+public:
+	struct Header
+	{
+		char magic[4];				// "MAZE"
+		uint32_t version;			// VERSION
+		int32_t width;				// MAZE_WIDTH
+		int32_t height;				// MAZE_HEIGHT
+		int32_t mutationRate;		// MUTATION_RATE the maze was made with
+		uint32_t seed;				// seed of the scene, so it can be regenerated or continued
+		uint32_t flags;				// Flags
+		int32_t stride;				// cells per stored row, always the packed layout
+		uint64_t storedCells;		// cells in the PATH grid and the distance field
+		int32_t goalX, goalY;		// goalPosition the distance field was flooded from
+		int32_t playerX, playerY;	// playerPosition
+		uint64_t distancesOffset;	// byte offset of the distance field, 0 when there is none
+	};
+	static_assert(sizeof(Header) == 64, "the header is part of the file format");
+
+	enum Flags
+	{
+		BORDER_FLAG = 0x01,				// grids include the sentinel border
+		DISTANCES_FLAG = 0x02,			// a distance field follows the PATH grid
+		NARROW_DISTANCES_FLAG = 0x04	// the distance field is 16 bit, set whenever storedCells fits in 16 bits
+	};
+
+	static const uint32_t VERSION = 1;
+
+	Header header;				// copy of the header of the open file
+	uint8_t* data = nullptr;	// the whole file, mapped
+	size_t size = 0;			// bytes in data
+	bool distancesAttached = false;	// the last Attach also handed the maze the stored distance field
+#if defined(_WIN32)
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#endif
+
+	MazeFile() = default;
+	MazeFile(const MazeFile&) = delete;
+	MazeFile& operator=(const MazeFile&) = delete;
+
+	~MazeFile()	// every MazeCore attached to this file must be destroyed first
+	{
+		Close();
+	}
+
+	static bool Save(MazeCore& maze, const char* path, bool withDistances)	// any layout is written as packed, withDistances floods first unless the field is already complete
+	{
+		if (withDistances && !maze.FieldComplete())
+			maze.FloodDistances();	// Attach trusts a stored field to be a whole flood from the stored goal, a query or an early stopped INCREMENTAL_SOLVE leaves less
+		const int border = maze.border;
+		const int stride = MazeCore::RowStride(maze.mazeFilledWidth, maze.SENTINEL_BORDER, true);
+		const int rows = maze.mazeFilledHeight + 2 * border;
+		const size_t storedCells = size_t(stride) * rows;
+		const bool narrow = storedCells <= UINT16_MAX;	// same rule as MazeCore, the packed layout may differ from the one being saved
+
+		Header out = { { 'M', 'A', 'Z', 'E' }, VERSION, maze.MAZE_WIDTH, maze.MAZE_HEIGHT, maze.MUTATION_RATE, maze.seed, 0, stride, storedCells,
+			maze.goalPosition.x, maze.goalPosition.y, maze.playerPosition.x, maze.playerPosition.y, 0 };
+		out.flags = (border ? BORDER_FLAG : 0) | (withDistances ? DISTANCES_FLAG : 0) | (narrow ? NARROW_DISTANCES_FLAG : 0);
+		out.distancesOffset = withDistances ? sizeof(Header) + storedCells / 8 : 0;
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+		file.write((const char*)&out, sizeof(out));
+
+		if (maze.PACKED_WALLS)
+			file.write((const char*)maze.mazeBits, storedCells / 8);	// already the file layout
+		else
+		{
+			std::vector<uint64_t> words(stride / 64);
+			for (int y = -border; y < rows - border; y++)
+			{
+				std::fill(words.begin(), words.end(), 0);
+				for (int x = -border; x < maze.mazeFilledWidth + border; x++)
+					if (maze.IsPath(maze.Index(x, y)))
+						words[(x + border) >> 6] |= uint64_t(1) << ((x + border) & 63);
+				file.write((const char*)words.data(), words.size() * sizeof(uint64_t));
+			}
+		}
+
+		if (withDistances)
+		{
+			std::vector<uint32_t> wide(narrow ? 0 : stride, UINT32_MAX);	// columns past the source row stay unreached
+			std::vector<uint16_t> slim(narrow ? stride : 0, UINT16_MAX);
+			for (int y = -border; y < rows - border; y++)
+			{
+				for (int x = -border; x < maze.mazeFilledWidth + border; x++)
+				{
+					uint32_t distance = maze.Distance(maze.Index(x, y));
+					if (narrow)
+						slim[x + border] = distance == UINT32_MAX ? UINT16_MAX : uint16_t(distance);
+					else
+						wide[x + border] = distance;
+				}
+				if (narrow)
+					file.write((const char*)slim.data(), slim.size() * sizeof(uint16_t));
+				else
+					file.write((const char*)wide.data(), wide.size() * sizeof(uint32_t));
+			}
+		}
+
+		file.close();
+		return bool(file);
+	}
+
+	bool Open(const char* path)	// map a file written by Save and check its header, nothing is read until it is touched
+	{
+		Close();
+#if defined(_WIN32)
+		file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		LARGE_INTEGER fileSize;
+		if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || !fileSize.QuadPart)
+			return Close(), false;
+		size = size_t(fileSize.QuadPart);
+		mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		if (!mapping)
+			return Close(), false;
+		data = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);	// private pages, writes stay in this process
+		if (!data)
+			return Close(), false;
+#else
+		int descriptor = open(path, O_RDONLY);
+		if (descriptor < 0)
+			return false;
+		struct stat status;
+		if (fstat(descriptor, &status) || !status.st_size)
+		{
+			close(descriptor);
+			return false;
+		}
+		size = size_t(status.st_size);
+		void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);	// private pages, writes stay in this process
+		close(descriptor);	// the mapping keeps the file open
+		if (mapped == MAP_FAILED)
+			return Close(), false;
+		data = (uint8_t*)mapped;
+#endif
+
+		if (size < sizeof(Header))
+			return Close(), false;
+		memcpy(&header, data, sizeof(Header));
+
+		const bool distancesStored = header.flags & DISTANCES_FLAG;
+		const size_t distanceBytes = header.flags & NARROW_DISTANCES_FLAG ? sizeof(uint16_t) : sizeof(uint32_t);
+		if (memcmp(header.magic, "MAZE", 4) || header.version != VERSION || header.width <= 0 || header.width > INT32_MAX / 2 || header.height <= 0 || header.height > INT32_MAX / 2 || header.mutationRate < 0
+			|| header.stride <= 0 || header.stride % 64 || header.storedCells % header.stride
+			|| header.goalX < 0 || header.goalX >= header.width * 2 || header.goalY < 0 || header.goalY >= header.height * 2
+			|| header.playerX < 0 || header.playerX >= header.width * 2 || header.playerY < 0 || header.playerY >= header.height * 2
+			|| size < sizeof(Header) + header.storedCells / 8
+			|| (distancesStored && (header.distancesOffset % 8 || header.distancesOffset < sizeof(Header) + header.storedCells / 8 || header.distancesOffset > size
+				|| (size - header.distancesOffset) / distanceBytes < header.storedCells)))
+			return Close(), false;
+		return true;
+	}
+
+	void Close()
+	{
+		distancesAttached = false;
+#if defined(_WIN32)
+		if (data)
+			UnmapViewOfFile(data);
+		if (mapping)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (data)
+			munmap(data, size);
+#endif
+		data = nullptr;
+		size = 0;
+	}
+
+	bool Attach(MazeCore& maze)	// use the mapped grids in place of the maze's own, the maze must be built with the header's size, border and PACKED_WALLS
+	{
+		if (!data || !maze.PACKED_WALLS || maze.MAZE_WIDTH != header.width || maze.MAZE_HEIGHT != header.height
+			|| maze.SENTINEL_BORDER != bool(header.flags & BORDER_FLAG) || maze.stride != header.stride || maze.storedCells != header.storedCells)
+			return false;
+
+		if (!maze.borrowedWalls)
+			delete[] maze.mazeBits;
+		maze.mazeBits = (uint64_t*)(data + sizeof(Header));
+		maze.borrowedWalls = true;
+
+		if ((header.flags & DISTANCES_FLAG) && maze.narrowDistances == bool(header.flags & NARROW_DISTANCES_FLAG))
+		{
+			if (!maze.borrowedDistances)
+			{
+				delete[] maze.distances;
+				delete[] maze.distances16;
+			}
+			maze.distances = maze.narrowDistances ? nullptr : (uint32_t*)(data + header.distancesOffset);
+			maze.distances16 = maze.narrowDistances ? (uint16_t*)(data + header.distancesOffset) : nullptr;
+			maze.borrowedDistances = true;
+			maze.queriedFront = SIZE_MAX;	// a whole field, not the cells of a POINT_TO_POINT query
+			maze.fieldRoot = maze.Index(header.goalX, header.goalY);	// flooded from the stored goal, so FindShortestPath only traces it
+			maze.fieldHead = maze.fieldTail = 0;	// complete, nothing left to resume
+			distancesAttached = true;
+		}
+		else
+		{
+			maze.fieldRoot = SIZE_MAX;	// the maze's own field belongs to whatever it held before
+			distancesAttached = false;
+		}
+		maze.landmarksReady = false;
+		maze.treeReady = false;
+
+		maze.MUTATION_RATE = header.mutationRate;
+		maze.Reseed(header.seed);
+		maze.goalPosition = { header.goalX, header.goalY };
+		maze.playerPosition = { header.playerX, header.playerY };
+		return true;
+	}
+
+	bool HasDistances() const	// Attach also attached a distance field, so TracePath can run without FloodDistances
+	{
+		return distancesAttached;
+	}
+};
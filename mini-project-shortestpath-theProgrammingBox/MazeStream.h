@@ -0,0 +1,109 @@
+#pragma once
+
+#include <fstream>
+
+#include "MazeCore.h"
+
+class MazeStream	// ELLER maze written out one filled row at a time, only O(MAZE_WIDTH) is ever held so the maze can be larger than memory
+{
+public:
+	int MAZE_WIDTH;				// Width of the maze
+	int MAZE_HEIGHT;			// Height of the maze
+	int MUTATION_RATE;			// chance that a wall gets flipped into a path, 0 or less for none
+
+	int mazeFilledWidth;		// Width of the maze including the walls
+	int mazeFilledHeight;		// Height of the maze including the walls
+	int rowWords;				// 64 bit words per filled row
+
+	unsigned int seed;			// same meaning as MazeCore::seed, a MazeCore on ELLER with this seed gives the same maze, mutations included
+
+	uint64_t* pathRow;			// filled row through the nodes, bit x is the PATH flag of cell x like a row of MazeCore::mazeBits
+	uint64_t* upRow;			// filled row between the nodes and the next row of nodes
+
+	MazeStream(int MAZE_WIDTH, int MAZE_HEIGHT, int MUTATION_RATE, unsigned int SEED)
+	{
+		this->MAZE_WIDTH = MAZE_WIDTH;
+		this->MAZE_HEIGHT = MAZE_HEIGHT;
+		this->MUTATION_RATE = MUTATION_RATE;
+		seed = SEED;
+
+		mazeFilledWidth = MAZE_WIDTH * 2;
+		mazeFilledHeight = MAZE_HEIGHT * 2;
+		rowWords = (mazeFilledWidth + 63) / 64;
+
+		pathRow = new uint64_t[rowWords];
+		upRow = new uint64_t[rowWords];
+	}
+
+	MazeStream(const MazeStream&) = delete;
+	MazeStream& operator=(const MazeStream&) = delete;
+
+	~MazeStream()
+	{
+		delete[] pathRow;
+		delete[] upRow;
+	}
+
+	template <typename Emit>
+	void Generate(Emit emit)	// calls emit(row, words) for every filled row from 0 to mazeFilledHeight - 1, words is only valid during the call
+	{
+		unsigned int generationState = MazeCore::MixSeed(seed, MazeCore::GENERATION_STREAM);
+		unsigned int mutationState = MazeCore::MixSeed(seed, MazeCore::MUTATION_STREAM);
+		MazeCore::EllerRows rows(MAZE_WIDTH);
+
+		for (int y = 0; y < MAZE_HEIGHT; y++)
+		{
+			memset(pathRow, 0, sizeof(uint64_t) * rowWords);
+			memset(upRow, 0, sizeof(uint64_t) * rowWords);
+			rows.Row(y == MAZE_HEIGHT - 1, generationState, [&](int x, int direction)
+			{
+				size_t cell = size_t(x) * 2;
+				if (direction == 3)
+					cell++;		// right of the node, on the node row
+				(direction == 3 ? pathRow : upRow)[cell >> 6] |= uint64_t(1) << (cell & 63);
+			});
+
+			for (size_t cell = 0; cell < size_t(mazeFilledWidth); cell += 2)	// centre cells and mutations, in the row order RandomizeMaze uses for ELLER
+			{
+				pathRow[cell >> 6] |= uint64_t(1) << (cell & 63);
+				if (!((upRow[cell >> 6] >> (cell & 63)) & 1) && MUTATION_RATE > 0 && MazeCore::XorShift32(mutationState) % MUTATION_RATE == 0)
+					upRow[cell >> 6] |= uint64_t(1) << (cell & 63);
+				if (!((pathRow[(cell + 1) >> 6] >> ((cell + 1) & 63)) & 1) && MUTATION_RATE > 0 && MazeCore::XorShift32(mutationState) % MUTATION_RATE == 0)
+					pathRow[(cell + 1) >> 6] |= uint64_t(1) << ((cell + 1) & 63);
+			}
+
+			emit(y * 2, pathRow);
+			emit(y * 2 + 1, upRow);
+		}
+	}
+
+	bool WriteBitmap(const char* path)	// binary PBM (P4) with walls black, row 0 at the top like in the viewer
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+
+		file << "P4\n" << mazeFilledWidth << ' ' << mazeFilledHeight << '\n';
+		const size_t rowBytes = (size_t(mazeFilledWidth) + 7) / 8;
+		uint8_t* bytes = new uint8_t[rowBytes];
+		Generate([&](int, const uint64_t* words)
+		{
+			for (size_t i = 0; i < rowBytes; i++)
+				bytes[i] = uint8_t(~ReverseBits(uint8_t(words[i >> 3] >> ((i & 7) * 8))));	// PBM packs the first pixel in the top bit, 1 is black
+			if (mazeFilledWidth & 7)
+				bytes[rowBytes - 1] &= uint8_t(0xFF << (8 - (mazeFilledWidth & 7)));	// padding bits stay 0
+			file.write((const char*)bytes, rowBytes);
+		});
+		delete[] bytes;
+		file.close();
+		return bool(file);
+	}
+
+	static uint8_t ReverseBits(uint8_t b)
+	{
+		b = uint8_t((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+		b = uint8_t((b & 0xCC) >> 2 | (b & 0x33) << 2);
+		b = uint8_t((b & 0xAA) >> 1 | (b & 0x55) << 1);
+		return b;
+	}
+};
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <cmath>
+
+#include "olcPixelGameEngine.h"
+#include "MazeCore.h"
+#include "MazeFade.h"
+
+using std::min;
+using olc::Pixel;
+
+class Maze : public olc::PixelGameEngine, public MazeCore	// thin viewer on top of the headless maze core
+{
+public:
+	float* drawingColor;		// purely cosmetic, used to fade between past and current distance colors
+	MazeFade::Kernel FADE_KERNEL = MazeFade::Detect();	// how DrawMaze fades drawingColor, the widest one the host runs
+	float FADE_RATE = 0.006f;	// share of the way to its distance color a cell covers per simulation step
+	int pendingFades = 0;		// simulation steps since drawingColor was last faded, applied at once by the next DrawMaze
+
+	static const int TILE_SIZE = 32;	// cells per side of a dirty tile
+	int tilesWide, tilesHigh;			// tiles over the filled maze, the last ones may be cut short
+	uint8_t* fadingTiles;				// 1 while DrawMaze still has to redraw a tile, cleared once none of its colors moved
+	bool redrawAll = true;				// the walls changed, Render clears the target before drawing every tile
+	std::vector<vi2d> overlayCells;		// cells the trails covered in the last frame, painted back to the maze before the trails are drawn again
+
+	uint8_t mazeLayer = 0;				// PGE layer holding only the maze, 0 draws the maze and the trails into the current draw target
+	uint8_t overlayLayer = 0;			// transparent PGE layer over the maze layer holding the goal trail, the player trail goes on it as decals
+	bool mazeDrawn = false;				// DrawMaze wrote pixels since the last Render, so the maze layer has to be uploaded again
+	bool newPath = true;				// shortestPath was solved again since the overlay drew it, otherwise it only loses cells from its back
+	std::vector<vi2d> drawnPath;		// the goal trail as the overlay layer shows it, the back it lost since is under the player trail
+
+	float numUpdateFrames;		// numUpdateFrames for the movement animation
+	float FPS;					// how many frames to update per second
+
+	int TRAIL_LENGTH;			// length of player trail
+	vi2d* playerTrail;			// purely cosmetic, list of previous player positions up to TRAIL_LENGTH positions long
+	int trailIndex = 0;			// keeps track of the circular array, instead of using a queue cuz fast
+
+	Maze(int MAZE_WIDTH, int MAZE_HEIGHT, int MUTATION_RATE, bool SENTINEL_BORDER = false, bool PACKED_WALLS = false, unsigned int SEED = 0) : MazeCore(MAZE_WIDTH, MAZE_HEIGHT, MUTATION_RATE, SENTINEL_BORDER, PACKED_WALLS, SEED)
+	{
+		sAppName = "Maze Generator and Solver";
+
+		FPS = mazeFilledWidth + mazeFilledHeight;
+		TRAIL_LENGTH = FPS * 0.2;
+
+		drawingColor = new float[mazeFilledWidth * mazeFilledHeight];	// purely cosmetic, used to fade between past and current distance colors
+		playerTrail = new vi2d[TRAIL_LENGTH];							// a trail behind the player, purely cosmetic
+
+		tilesWide = (mazeFilledWidth + TILE_SIZE - 1) / TILE_SIZE;
+		tilesHigh = (mazeFilledHeight + TILE_SIZE - 1) / TILE_SIZE;
+		fadingTiles = new uint8_t[tilesWide * tilesHigh];
+		memset(fadingTiles, 1, tilesWide * tilesHigh);
+	}
+
+	~Maze()
+	{
+		delete[] drawingColor;
+		delete[] playerTrail;
+		delete[] fadingTiles;
+	}
+
+	void InvalidateTiles(bool walls)	// the distances and the path changed so every tile fades again, walls also clears the target on the next Render
+	{
+		memset(fadingTiles, 1, tilesWide * tilesHigh);
+		redrawAll |= walls;
+		newPath = true;
+	}
+
+	void DrawMaze(int steps = 1)	// fade drawingColor by steps simulation steps in one pass, exact while the distances stay the same
+	{
+		const float fade = 1.0f - std::pow(1.0f - FADE_RATE, float(steps));
+		if (narrowDistances)
+			PACKED_WALLS ? DrawMaze<true, uint16_t>(fade) : DrawMaze<false, uint16_t>(fade);
+		else
+			PACKED_WALLS ? DrawMaze<true, uint32_t>(fade) : DrawMaze<false, uint32_t>(fade);
+	}
+
+	template <bool PACKED, typename T>
+	void DrawMaze(float fade)	// T is the stored distance type, writes the draw target's pixels directly in NORMAL pixel mode, only the tiles that are still fading
+	{
+		const T* distances = DistanceArray<T>();
+		olc::Sprite* target = GetDrawTarget();
+		const int width = min(mazeFilledWidth, target->width);		// clip like Draw would
+		const int height = min(mazeFilledHeight, target->height);
+		const float scale = 255.0f / (float(largestDistance) + 1.0f);	// one division per frame instead of one per cell
+		for (int ty = 0; ty * TILE_SIZE < height; ty++)
+			for (int tx = 0; tx * TILE_SIZE < width; tx++)
+			{
+				uint8_t& fading = fadingTiles[ty * tilesWide + tx];
+				if (!fading)
+					continue;	// settled, its pixels are still on the target
+				mazeDrawn = true;
+				const int x = tx * TILE_SIZE;
+				const int count = min(TILE_SIZE, width - x);
+				bool changed = false;
+				for (int y = ty * TILE_SIZE; y < min(ty * TILE_SIZE + TILE_SIZE, height); y++)
+					changed |= MazeFade::Row<PACKED, T>(FADE_KERNEL, *this, distances, Index(x, y), count, scale, fade, drawingColor + size_t(y) * mazeFilledWidth + x, (uint32_t*)target->GetData() + size_t(y) * target->width + x);
+				fading = changed || fade == 0.0f;	// no steps since the last frame says nothing about convergence
+			}
+	}
+
+	Pixel MazePixel(vi2d cell)	// what DrawMaze last left on a cell
+	{
+		return IsPath(Index(cell.x, cell.y)) ? Pixel(MazeFade::MAGENTA | uint32_t(drawingColor[size_t(cell.y) * mazeFilledWidth + cell.x]) << 8) : Pixel(0, 0, 0);
+	}
+
+	void DrawGoalTrail()
+	{
+		for (int i = shortestPath.size(); i--;)
+			Draw(shortestPath[i].x, shortestPath[i].y, Pixel(255, 0, 0));	// red
+	}
+
+	void DrawPlayerTrail()
+	{
+		for (int i = TRAIL_LENGTH; i--;)
+		{
+			const Pixel color(255, i * 255 / TRAIL_LENGTH, 0);	// orange to yellow
+			if (mazeLayer)
+				FillRectDecal({ float(playerTrail[trailIndex].x), float(playerTrail[trailIndex].y) }, { 1.0f, 1.0f }, color);	// over the overlay layer, nothing is uploaded
+			else
+				Draw(playerTrail[trailIndex].x, playerTrail[trailIndex].y, color);
+			trailIndex++;
+			trailIndex -= (trailIndex == TRAIL_LENGTH) * TRAIL_LENGTH;
+		}
+	}
+
+	void DrawOverlay()	// redraws the goal trail on the overlay layer only when it was solved again or walked further than the player trail covers, then the player trail as decals
+	{
+		olc::Sprite* maze = GetDrawTarget();
+		SetDrawTarget(GetLayers()[overlayLayer].pDrawTarget.Sprite());	// the sprite overload leaves bUpdate and the decal layer alone
+		if (std::exchange(newPath, false))
+		{
+			for (vi2d cell : drawnPath)
+				Draw(cell.x, cell.y, olc::BLANK);
+			drawnPath.assign(shortestPath.begin(), shortestPath.end());
+			DrawGoalTrail();
+			GetLayers()[overlayLayer].bUpdate = true;
+		}
+		else if (drawnPath.size() > shortestPath.size() + size_t(TRAIL_LENGTH))	// every cell the player walked off the path joined the player trail, which hides the last TRAIL_LENGTH of them
+		{
+			for (; drawnPath.size() > shortestPath.size(); drawnPath.pop_back())
+				Draw(drawnPath.back().x, drawnPath.back().y, olc::BLANK);
+			GetLayers()[overlayLayer].bUpdate = true;
+		}
+		SetDrawTarget(maze);
+		DrawPlayerTrail();
+	}
+
+	void MovePlayer(float fElapsedTime)
+	{
+		vi2d previousPosition = playerPosition;
+		if (MazeCore::MovePlayer())
+		{
+			playerTrail[trailIndex++] = previousPosition;				// add previous position to trail
+			trailIndex -= (trailIndex >= TRAIL_LENGTH) * TRAIL_LENGTH;	// reset trail index if it goes over the trail length
+		}
+		else
+			InvalidateTiles(false);	// a new goal, every distance changed
+	}
+
+	void NewScene()
+	{
+		MazeCore::NewScene();
+		for (int i = mazeFilledWidth * mazeFilledHeight; i--;)		// set all colors to white
+			drawingColor[i] = 255;
+		for (int i = TRAIL_LENGTH; i--;) playerTrail[i] = playerPosition;	// player trail reset
+		pendingFades = 0;
+		InvalidateTiles(true);
+	}
+
+	void Render()	// only redraws what changed since the last Render, the rest of the target is kept
+	{
+		if (std::exchange(redrawAll, false))
+		{
+			Clear(Pixel(0, 0, 0));	// clear the screen with black
+			overlayCells.clear();
+		}
+		for (vi2d cell : overlayCells)
+			Draw(cell.x, cell.y, MazePixel(cell));	// the trails moved on, tiles that are still fading are drawn over anyway
+		DrawMaze(std::exchange(pendingFades, 0));
+		if (mazeLayer)
+		{
+			if (std::exchange(mazeDrawn, false))
+				GetLayers()[mazeLayer].bUpdate = true;	// the engine uploads the maze texture only on frames it changed in
+			DrawOverlay();
+			return;
+		}
+		DrawGoalTrail();
+		DrawPlayerTrail();
+		overlayCells.assign(shortestPath.begin(), shortestPath.end());	// only a shared target keeps trail pixels to paint back
+		overlayCells.insert(overlayCells.end(), playerTrail, playerTrail + TRAIL_LENGTH);
+	}
+
+	bool OnUserCreate()
+	{
+		overlayLayer = uint8_t(CreateLayer());	// the trails, the engine draws higher layers first so this one goes over the maze
+		mazeLayer = uint8_t(CreateLayer());		// the maze, drawn under every other layer
+		EnableLayer(overlayLayer, true);
+		EnableLayer(mazeLayer, true);
+		SetDrawTarget(overlayLayer);			// decals go to the last layer set by index, so the player trail lands over the goal trail
+		Clear(olc::BLANK);						// new layers start opaque black
+		SetDrawTarget(GetLayers()[mazeLayer].pDrawTarget.Sprite());	// pixels go to the maze, the sprite overload keeps the decals on the overlay
+		SetLayerCustomRenderFunction(0, [] {});	// layer 0 would be uploaded every frame and stays empty, so it is not drawn at all
+		NewScene();
+
+		return true;
+	}
+
+	bool OnUserUpdate(float fElapsedTime)
+	{
+		if (GetKey(olc::SPACE).bPressed)
+			NewScene();							// create a new scene when space is pressed
+		if (GetMouse(0).bPressed && SetCell(GetMouseX(), GetMouseY(), !IsPath(Index(GetMouseX(), GetMouseY()))))
+		{
+			FindShortestPath();					// toggle the clicked cell, the distances are repaired instead of flooded again
+			InvalidateTiles(false);
+			Draw(GetMouseX(), GetMouseY(), MazePixel({ GetMouseX(), GetMouseY() }));	// DrawMaze only paints paths, a new wall is painted here
+		}
+
+		numUpdateFrames += fElapsedTime * FPS;	// F / S * S = F
+		while (numUpdateFrames > 0)				// while there are frames to update
+		{
+			pendingFades++;						// every step fades the colors once towards the distances it starts from
+			if (shortestPath.size() < 2)
+				DrawMaze(std::exchange(pendingFades, 0));	// this step picks a new goal and solves again, fade with the old distances first
+			MovePlayer(fElapsedTime);			// move the player
+			numUpdateFrames--;					// subtract a frame
+		}
+		Render();								// render the scene once per displayed frame
+
+		return true;
+	}
+};